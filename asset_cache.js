@@ -0,0 +1,165 @@
+/**
+ * Static Asset Cache
+ * Loads every file under the served directory into memory once, together
+ * with gzip and brotli variants precomputed at maximum compression and a
+ * strong ETag per variant. Requests are then answered from memory without
+ * touching the disk. A directory watcher reloads a file when it changes and
+ * drops it when it is removed, so editing the frontend needs no restart.
+ */
+
+const fs = require('fs');
+const path = require('path');
+const zlib = require('zlib');
+const crypto = require('crypto');
+
+// Smaller files gain too little from compression to be worth the extra variants
+const MIN_COMPRESS_SIZE = 256;
+const COMPRESSIBLE = new Set(['.html', '.js', '.css', '.json', '.svg', '.txt', '.ico']);
+const RELOAD_DELAY_MS = 50;
+
+class AssetCache {
+    constructor(root, mimeTypes) {
+        this.root = path.resolve(root);
+        this.mimeTypes = mimeTypes;
+        this.assets = new Map(); // URL pathname -> asset
+        this.watchers = [];
+        this.pendingReloads = new Map();
+    }
+
+    // Reads the whole tree synchronously; called once before the server listens
+    load() {
+        this.assets.clear();
+        const walk = (directory) => {
+            for (const entry of fs.readdirSync(directory, { withFileTypes: true })) {
+                const filePath = path.join(directory, entry.name);
+                if (entry.isDirectory()) {
+                    walk(filePath);
+                } else if (entry.isFile()) {
+                    this.loadFile(filePath);
+                }
+            }
+        };
+        walk(this.root);
+        return this.assets.size;
+    }
+
+    loadFile(filePath) {
+        const urlPath = this.urlPathFor(filePath);
+        let body;
+        try {
+            body = fs.readFileSync(filePath);
+        } catch (error) {
+            this.assets.delete(urlPath);
+            return;
+        }
+
+        const ext = path.extname(filePath).toLowerCase();
+        const hash = crypto.createHash('sha1').update(body).digest('hex').slice(0, 20);
+        const asset = {
+            contentType: this.mimeTypes[ext] || 'application/octet-stream',
+            ext,
+            variants: { identity: { body, etag: `"${hash}"` } }
+        };
+
+        // Each encoding is a different representation, so it gets its own ETag
+        if (COMPRESSIBLE.has(ext) && body.length >= MIN_COMPRESS_SIZE) {
+            const gzip = zlib.gzipSync(body, { level: zlib.constants.Z_BEST_COMPRESSION });
+            const br = zlib.brotliCompressSync(body, {
+                params: {
+                    [zlib.constants.BROTLI_PARAM_QUALITY]: zlib.constants.BROTLI_MAX_QUALITY,
+                    [zlib.constants.BROTLI_PARAM_SIZE_HINT]: body.length
+                }
+            });
+            if (gzip.length < body.length) asset.variants.gzip = { body: gzip, etag: `"${hash}-gz"` };
+            if (br.length < body.length) asset.variants.br = { body: br, etag: `"${hash}-br"` };
+        }
+        this.assets.set(urlPath, asset);
+    }
+
+    urlPathFor(filePath) {
+        return '/' + path.relative(this.root, filePath).split(path.sep).join('/');
+    }
+
+    lookup(pathname) {
+        return this.assets.get(pathname);
+    }
+
+    // Reloads changed files after a short delay, since editors emit bursts of events
+    watch() {
+        const onChange = (directory) => (eventType, fileName) => {
+            if (!fileName) {
+                this.load(); // platform did not say which file changed
+                return;
+            }
+            const filePath = path.join(directory, fileName.toString());
+            clearTimeout(this.pendingReloads.get(filePath));
+            this.pendingReloads.set(filePath, setTimeout(() => {
+                this.pendingReloads.delete(filePath);
+                fs.stat(filePath, (error, stats) => {
+                    if (error) {
+                        // Removed (or a directory went away): drop everything below it
+                        const prefix = this.urlPathFor(filePath);
+                        for (const urlPath of [...this.assets.keys()]) {
+                            if (urlPath === prefix || urlPath.startsWith(prefix + '/')) {
+                                this.assets.delete(urlPath);
+                            }
+                        }
+                    } else if (stats.isFile()) {
+                        this.loadFile(filePath);
+                    } else if (stats.isDirectory()) {
+                        this.load();
+                    }
+                });
+            }, RELOAD_DELAY_MS));
+        };
+
+        try {
+            this.watchers.push(fs.watch(this.root, { recursive: true }, onChange(this.root)));
+        } catch (error) {
+            // Older Node on Linux has no recursive watch: watch each directory
+            const watchTree = (directory) => {
+                this.watchers.push(fs.watch(directory, onChange(directory)));
+                for (const entry of fs.readdirSync(directory, { withFileTypes: true })) {
+                    if (entry.isDirectory()) watchTree(path.join(directory, entry.name));
+                }
+            };
+            watchTree(this.root);
+        }
+    }
+
+    close() {
+        this.watchers.forEach((watcher) => watcher.close());
+        this.watchers = [];
+        this.pendingReloads.forEach((timer) => clearTimeout(timer));
+        this.pendingReloads.clear();
+    }
+
+    // Best variant the client accepts: brotli, then gzip, then the raw file
+    static negotiate(asset, acceptEncoding) {
+        const accepted = new Set();
+        for (const part of (acceptEncoding || '').split(',')) {
+            const [coding, ...params] = part.trim().toLowerCase().split(';');
+            const refused = params.some((param) => /^\s*q=0(\.0*)?\s*$/.test(param));
+            if (coding.trim() && !refused) accepted.add(coding.trim());
+        }
+        for (const encoding of ['br', 'gzip']) {
+            if (asset.variants[encoding] && (accepted.has(encoding) || accepted.has('*'))) {
+                return encoding;
+            }
+        }
+        return 'identity';
+    }
+
+    // If-None-Match uses weak comparison (RFC 9110 13.1.2)
+    static matches(ifNoneMatch, etag) {
+        if (!ifNoneMatch) {
+            return false;
+        }
+        if (ifNoneMatch.trim() === '*') {
+            return true;
+        }
+        return ifNoneMatch.split(',').some((tag) => tag.trim().replace(/^W\//, '') === etag);
+    }
+}
+
+module.exports = { AssetCache };
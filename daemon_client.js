@@ -0,0 +1,262 @@
+/**
+ * Routing Daemon Client
+ * Keeps a small pool of persistent Unix socket connections to routing_daemon
+ * and speaks its binary framing (src/daemon_protocol.h). Requests are
+ * pipelined: each one gets an id, goes out on the least busy connection,
+ * and resolves when the response frame with the same id comes back.
+ * Connections that drop are reopened on the next request.
+ */
+
+const net = require('net');
+
+const HEADER_SIZE = 12;
+
+const FrameType = { ROUTE: 1, MATRIX: 2, SORT: 3, STATUS: 4 };
+const FrameStatus = { OK: 0, NOT_FOUND: 1, BAD_REQUEST: 2, UNKNOWN_TYPE: 3, OVERLOADED: 4 };
+const RouteAlgorithm = { dijkstra: 0, astar: 1, bidirectional: 2 };
+const SortAlgorithm = { introsort: 0, mergesort: 1, heapsort: 2 };
+const NodeRefKind = { ID: 0, NAME: 1, COORDINATES: 2 };
+const Metric = { distance: 0, time: 1 };
+
+// Error carrying the daemon's (or transport's) status for HTTP mapping
+class DaemonError extends Error {
+    constructor(message, status) {
+        super(message);
+        this.status = status;
+    }
+}
+
+// Little-endian payload builder matching FrameWriter
+class PayloadWriter {
+    constructor() {
+        this.parts = [];
+    }
+
+    u8(value) { const b = Buffer.alloc(1); b.writeUInt8(value); this.parts.push(b); }
+    u32(value) { const b = Buffer.alloc(4); b.writeUInt32LE(value); this.parts.push(b); }
+    i32(value) { const b = Buffer.alloc(4); b.writeInt32LE(value); this.parts.push(b); }
+    f64(value) { const b = Buffer.alloc(8); b.writeDoubleLE(value); this.parts.push(b); }
+    string(text) {
+        const bytes = Buffer.from(text, 'utf8').subarray(0, 0xffff);
+        const length = Buffer.alloc(2);
+        length.writeUInt16LE(bytes.length);
+        this.parts.push(length, bytes);
+    }
+
+    // A node is an id (number), a name (string) or a position ({ lat, lon })
+    nodeRef(node) {
+        if (typeof node === 'number') {
+            this.u8(NodeRefKind.ID);
+            this.u32(node);
+        } else if (typeof node === 'string') {
+            this.u8(NodeRefKind.NAME);
+            this.string(node);
+        } else {
+            this.u8(NodeRefKind.COORDINATES);
+            this.f64(node.lat);
+            this.f64(node.lon);
+        }
+    }
+
+    finish() {
+        return Buffer.concat(this.parts);
+    }
+}
+
+// Bounds-checked cursor matching FrameReader
+class PayloadReader {
+    constructor(buffer) {
+        this.buffer = buffer;
+        this.offset = 0;
+    }
+
+    take(size) {
+        if (this.offset + size > this.buffer.length) {
+            throw new DaemonError('Truncated response from routing daemon', FrameStatus.BAD_REQUEST);
+        }
+        const start = this.offset;
+        this.offset += size;
+        return start;
+    }
+
+    u32() { return this.buffer.readUInt32LE(this.take(4)); }
+    i32() { return this.buffer.readInt32LE(this.take(4)); }
+    u64() { return Number(this.buffer.readBigUInt64LE(this.take(8))); }
+    f64() { return this.buffer.readDoubleLE(this.take(8)); }
+    string() {
+        const length = this.buffer.readUInt16LE(this.take(2));
+        const start = this.take(length);
+        return this.buffer.toString('utf8', start, start + length);
+    }
+}
+
+class DaemonConnection {
+    constructor(socketPath, onClose) {
+        this.pending = new Map();
+        this.buffer = Buffer.alloc(0);
+        this.closed = false;
+        this.socket = net.createConnection(socketPath);
+        this.socket.setNoDelay(true);
+        this.socket.on('data', (chunk) => this.receive(chunk));
+        this.socket.on('error', () => {}); // 'close' follows and fails the pending requests
+        this.socket.on('close', () => {
+            this.closed = true;
+            for (const entry of this.pending.values()) {
+                clearTimeout(entry.timer);
+                entry.reject(new DaemonError('Routing daemon unavailable', null));
+            }
+            this.pending.clear();
+            onClose(this);
+        });
+    }
+
+    send(frame, requestId, timeoutMs) {
+        return new Promise((resolve, reject) => {
+            const timer = setTimeout(() => {
+                this.pending.delete(requestId);
+                reject(new DaemonError('Routing daemon timed out', null));
+            }, timeoutMs);
+            this.pending.set(requestId, { resolve, reject, timer });
+            this.socket.write(frame);
+        });
+    }
+
+    receive(chunk) {
+        this.buffer = this.buffer.length === 0 ? chunk : Buffer.concat([this.buffer, chunk]);
+        while (this.buffer.length >= HEADER_SIZE) {
+            const length = this.buffer.readUInt32LE(0);
+            if (this.buffer.length < HEADER_SIZE + length) {
+                break;
+            }
+            const requestId = this.buffer.readUInt32LE(4);
+            const status = this.buffer.readUInt16LE(10);
+            const payload = this.buffer.subarray(HEADER_SIZE, HEADER_SIZE + length);
+            this.buffer = this.buffer.subarray(HEADER_SIZE + length);
+
+            const entry = this.pending.get(requestId);
+            if (entry) {
+                this.pending.delete(requestId);
+                clearTimeout(entry.timer);
+                entry.resolve({ status, payload });
+            }
+        }
+    }
+}
+
+class DaemonClient {
+    constructor(socketPath, poolSize = 4, timeoutMs = 10000) {
+        this.socketPath = socketPath;
+        this.poolSize = poolSize;
+        this.timeoutMs = timeoutMs;
+        this.connections = [];
+        this.nextRequestId = 1;
+    }
+
+    // Least busy open connection, opening a new one while the pool has room
+    acquire() {
+        let best = null;
+        for (const connection of this.connections) {
+            if (!best || connection.pending.size < best.pending.size) {
+                best = connection;
+            }
+        }
+        if (!best || (best.pending.size > 0 && this.connections.length < this.poolSize)) {
+            best = new DaemonConnection(this.socketPath, (closed) => {
+                this.connections = this.connections.filter((connection) => connection !== closed);
+            });
+            this.connections.push(best);
+        }
+        return best;
+    }
+
+    async request(type, payload) {
+        const requestId = this.nextRequestId;
+        this.nextRequestId = (this.nextRequestId % 0xffffffff) + 1;
+
+        const header = Buffer.alloc(HEADER_SIZE);
+        header.writeUInt32LE(payload.length, 0);
+        header.writeUInt32LE(requestId, 4);
+        header.writeUInt16LE(type, 8);
+        header.writeUInt16LE(0, 10);
+
+        const response = await this.acquire().send(Buffer.concat([header, payload]), requestId, this.timeoutMs);
+        if (response.status !== FrameStatus.OK) {
+            const messages = {
+                [FrameStatus.NOT_FOUND]: 'Node not found or no path',
+                [FrameStatus.BAD_REQUEST]: 'Malformed request',
+                [FrameStatus.UNKNOWN_TYPE]: 'Unknown request type',
+                [FrameStatus.OVERLOADED]: 'Routing daemon overloaded'
+            };
+            throw new DaemonError(messages[response.status] || 'Routing daemon error', response.status);
+        }
+        return new PayloadReader(response.payload);
+    }
+
+    async route(from, to, metric = 'distance', algorithm = 'dijkstra') {
+        const writer = new PayloadWriter();
+        writer.u8(Metric[metric] || 0);
+        writer.u8(RouteAlgorithm[algorithm] || 0);
+        writer.nodeRef(from);
+        writer.nodeRef(to);
+
+        const reader = await this.request(FrameType.ROUTE, writer.finish());
+        const result = { distance: reader.f64(), time: reader.f64(), settled: reader.u32(), path: [] };
+        const count = reader.u32();
+        for (let i = 0; i < count; i++) {
+            const id = reader.u32();
+            const name = reader.string();
+            result.path.push(name ? { id, name } : { id });
+        }
+        return result;
+    }
+
+    async matrix(sources, targets, metric = 'distance') {
+        const writer = new PayloadWriter();
+        writer.u8(Metric[metric] || 0);
+        writer.u32(sources.length);
+        writer.u32(targets.length);
+        sources.forEach((node) => writer.nodeRef(node));
+        targets.forEach((node) => writer.nodeRef(node));
+
+        const reader = await this.request(FrameType.MATRIX, writer.finish());
+        const rows = reader.u32();
+        const cols = reader.u32();
+        const values = [];
+        for (let r = 0; r < rows; r++) {
+            const row = [];
+            for (let c = 0; c < cols; c++) {
+                const value = reader.f64();
+                row.push(Number.isFinite(value) ? value : null); // JSON has no Infinity
+            }
+            values.push(row);
+        }
+        return { rows, cols, values };
+    }
+
+    async sort(values, algorithm = 'introsort') {
+        const writer = new PayloadWriter();
+        writer.u8(SortAlgorithm[algorithm] || 0);
+        writer.u32(values.length);
+        values.forEach((value) => writer.i32(value));
+
+        const reader = await this.request(FrameType.SORT, writer.finish());
+        const count = reader.u32();
+        const sorted = new Array(count);
+        for (let i = 0; i < count; i++) {
+            sorted[i] = reader.i32();
+        }
+        return sorted;
+    }
+
+    async status() {
+        const reader = await this.request(FrameType.STATUS, Buffer.alloc(0));
+        return { nodes: reader.u32(), arcs: reader.u32(), workers: reader.u32(), served: reader.u64() };
+    }
+
+    close() {
+        this.connections.forEach((connection) => connection.socket.destroy());
+        this.connections = [];
+    }
+}
+
+module.exports = { DaemonClient, DaemonError, FrameStatus, RouteAlgorithm, SortAlgorithm };
@@ -4,13 +4,25 @@
  */
 
 const http = require('http');
-const fs = require('fs');
 const path = require('path');
 const url = require('url');
+const { DaemonClient, DaemonError, FrameStatus } = require('./daemon_client');
+const { AssetCache } = require('./asset_cache');
 
 // Configuration
-const PORT = 3000 || "https://sorting-visualizer-ggxr.onrender.com";
+const PORT = parseInt(process.env.PORT, 10) || 3000;
 const DIRECTORY = 'frontend';
+const KEEP_ALIVE_TIMEOUT_MS = 65000;
+const DAEMON_SOCKET = process.env.DAEMON_SOCKET || '/tmp/pathfinding.sock';
+const DAEMON_POOL_SIZE = parseInt(process.env.DAEMON_POOL_SIZE, 10) || 4;
+const MAX_API_BODY = 1 << 20;
+// Wire ranges of the daemon protocol: node ids are uint32, sort values int32
+const MAX_NODE_ID = 0xffffffff;
+const MIN_INT32 = -0x80000000;
+const MAX_INT32 = 0x7fffffff;
+
+// /api/* is answered by the routing daemon (make run-daemon)
+const daemon = new DaemonClient(DAEMON_SOCKET, DAEMON_POOL_SIZE);
 
 // MIME types for different file extensions
 const mimeTypes = {
@@ -26,31 +38,26 @@ const mimeTypes = {
     '.txt': 'text/plain'
 };
 
-// Create HTTP server
-const server = http.createServer((req, res) => {
-    // Parse URL
-    const parsedUrl = url.parse(req.url);
-    let pathname = parsedUrl.pathname;
-    
-    // Default to combined.html if root is requested
-    if (pathname === '/') {
-        pathname = '/combined.html';
-    }
-    
-    // Get file path
-    const filePath = path.join(__dirname, DIRECTORY, pathname);
-    
-    // Get file extension
-    const ext = path.extname(filePath).toLowerCase();
-    const contentType = mimeTypes[ext] || 'application/octet-stream';
-    
-    // Read file
-    fs.readFile(filePath, (err, data) => {
-        if (err) {
-            // File not found
-            if (err.code === 'ENOENT') {
-                res.writeHead(404, { 'Content-Type': 'text/html' });
-                res.end(`
+// Pages revalidate every time (cheap with ETags) so a deploy shows up at
+// once; scripts and styles are not fingerprinted, so they are only cached
+// briefly, and images for a day
+const CACHE_POLICIES = {
+    '.html': 'no-cache',
+    '.js': 'public, max-age=300',
+    '.css': 'public, max-age=300',
+    '.json': 'no-cache'
+};
+const DEFAULT_CACHE_POLICY = 'public, max-age=86400';
+
+// Every frontend file lives in memory with its compressed variants
+const assets = new AssetCache(path.join(__dirname, DIRECTORY), mimeTypes);
+
+function escapeHtml(text) {
+    return text.replace(/[&<>"']/g, (c) => `&#${c.charCodeAt(0)};`);
+}
+
+function notFoundPage(pathname) {
+    return `
                     <!DOCTYPE html>
                     <html>
                     <head>
@@ -68,7 +75,7 @@ const server = http.createServer((req, res) => {
                     </head>
                     <body>
                         <div class="error">404</div>
-                        <div class="message">Page not found: ${pathname}</div>
+                        <div class="message">Page not found: ${escapeHtml(pathname)}</div>
                         <div class="links">
                             <a href="/combined.html">🏠 Combined Interface</a>
                             <a href="/index.html">📊 Sorting Visualizer</a>
@@ -76,63 +83,244 @@ const server = http.createServer((req, res) => {
                         </div>
                     </body>
                     </html>
-                `);
-            } else {
-                // Server error
-                res.writeHead(500, { 'Content-Type': 'text/plain' });
-                res.end('Internal Server Error');
+                `;
+}
+
+function sendJson(res, statusCode, body) {
+    res.writeHead(statusCode, {
+        'Content-Type': 'application/json',
+        'Access-Control-Allow-Origin': '*',
+        'Cache-Control': 'no-store'
+    });
+    res.end(JSON.stringify(body));
+}
+
+function readJsonBody(req) {
+    return new Promise((resolve, reject) => {
+        const chunks = [];
+        let size = 0;
+        req.on('data', (chunk) => {
+            size += chunk.length;
+            if (size > MAX_API_BODY) {
+                reject(new DaemonError('Request body too large', FrameStatus.BAD_REQUEST));
+                req.destroy();
+                return;
             }
-            return;
-        }
-        
-        // Set CORS headers
-        res.setHeader('Access-Control-Allow-Origin', '*');
-        res.setHeader('Access-Control-Allow-Methods', 'GET, POST, OPTIONS');
-        res.setHeader('Access-Control-Allow-Headers', 'Content-Type');
-        
-        // Set content type and send response
-        res.writeHead(200, { 'Content-Type': contentType });
-        res.end(data);
+            chunks.push(chunk);
+        });
+        req.on('end', () => {
+            let body;
+            try {
+                body = chunks.length > 0 ? JSON.parse(Buffer.concat(chunks).toString('utf8')) : {};
+            } catch (error) {
+                reject(new DaemonError('Invalid JSON body', FrameStatus.BAD_REQUEST));
+                return;
+            }
+            if (body === null || typeof body !== 'object' || Array.isArray(body)) {
+                reject(new DaemonError('JSON body must be an object', FrameStatus.BAD_REQUEST));
+                return;
+            }
+            resolve(body);
+        });
+        req.on('error', reject);
     });
+}
+
+// Query endpoints are a node id ("42"), a city name, or fromLat/fromLon style coordinates
+function parseEndpoint(query, prefix) {
+    const lat = query[`${prefix}Lat`];
+    const lon = query[`${prefix}Lon`];
+    if (lat !== undefined && lon !== undefined) {
+        return parseNode({ lat: parseFloat(lat), lon: parseFloat(lon) }, `'${prefix}'`);
+    }
+    const value = query[prefix];
+    if (typeof value !== 'string') {
+        throw new DaemonError(`Missing '${prefix}'`, FrameStatus.BAD_REQUEST);
+    }
+    return parseNode(/^\d+$/.test(value) ? Number(value) : value, `'${prefix}'`);
+}
+
+// A node is a uint32 id, a name, or finite { lat, lon }; anything else would
+// make the payload writer throw, so reject it here as a bad request
+function parseNode(node, description) {
+    if (typeof node === 'string') {
+        return node;
+    }
+    if (typeof node === 'number') {
+        if (Number.isInteger(node) && node >= 0 && node <= MAX_NODE_ID) {
+            return node;
+        }
+    } else if (node !== null && typeof node === 'object' &&
+               Number.isFinite(node.lat) && Number.isFinite(node.lon)) {
+        return { lat: node.lat, lon: node.lon };
+    }
+    throw new DaemonError(`${description} must be a node id, a name or a position`, FrameStatus.BAD_REQUEST);
+}
+
+function parseNodeList(list, field) {
+    if (!Array.isArray(list)) {
+        throw new DaemonError(`'${field}' must be an array`, FrameStatus.BAD_REQUEST);
+    }
+    return list.map((node) => parseNode(Array.isArray(node) ? { lat: node[0], lon: node[1] } : node,
+        `Each entry of '${field}'`));
+}
+
+function parseSortValues(values) {
+    if (!Array.isArray(values) ||
+        !values.every((value) => Number.isInteger(value) && value >= MIN_INT32 && value <= MAX_INT32)) {
+        throw new DaemonError("'values' must be an array of 32-bit integers", FrameStatus.BAD_REQUEST);
+    }
+    return values;
+}
+
+async function handleApi(req, res, pathname, query) {
+    try {
+        if (req.method === 'OPTIONS') {
+            res.writeHead(204, {
+                'Access-Control-Allow-Origin': '*',
+                'Access-Control-Allow-Methods': 'GET, POST, OPTIONS',
+                'Access-Control-Allow-Headers': 'Content-Type'
+            });
+            res.end();
+        } else if (pathname === '/api/route' && req.method === 'GET') {
+            const result = await daemon.route(parseEndpoint(query, 'from'), parseEndpoint(query, 'to'),
+                query.metric, query.algorithm);
+            sendJson(res, 200, result);
+        } else if (pathname === '/api/matrix' && req.method === 'POST') {
+            const body = await readJsonBody(req);
+            const result = await daemon.matrix(parseNodeList(body.sources, 'sources'),
+                parseNodeList(body.targets, 'targets'), body.metric);
+            sendJson(res, 200, result);
+        } else if (pathname === '/api/sort' && req.method === 'POST') {
+            const body = await readJsonBody(req);
+            sendJson(res, 200, { values: await daemon.sort(parseSortValues(body.values), body.algorithm) });
+        } else if (pathname === '/api/status' && req.method === 'GET') {
+            sendJson(res, 200, await daemon.status());
+        } else {
+            sendJson(res, 404, { error: `Unknown endpoint: ${req.method} ${pathname}` });
+        }
+    } catch (error) {
+        const codes = {
+            [FrameStatus.NOT_FOUND]: 404,
+            [FrameStatus.BAD_REQUEST]: 400,
+            [FrameStatus.UNKNOWN_TYPE]: 400
+        };
+        // Transport failures and overload both mean "try again later"
+        const statusCode = error instanceof DaemonError ? codes[error.status] || 503 : 500;
+        sendJson(res, statusCode, { error: error.message });
+    }
+}
+
+// Create HTTP server
+const server = http.createServer((req, res) => {
+    // Parse URL
+    const parsedUrl = url.parse(req.url, true);
+    let pathname = parsedUrl.pathname;
+    
+    if (pathname.startsWith('/api/')) {
+        handleApi(req, res, pathname, parsedUrl.query);
+        return;
+    }
+    
+    // Default to combined.html if root is requested
+    if (pathname === '/') {
+        pathname = '/combined.html';
+    }
+    
+    if (req.method !== 'GET' && req.method !== 'HEAD') {
+        res.writeHead(405, { 'Allow': 'GET, HEAD', 'Content-Type': 'text/plain' });
+        res.end('Method Not Allowed');
+        return;
+    }
+    
+    let asset;
+    try {
+        asset = assets.lookup(decodeURIComponent(pathname));
+    } catch (error) {
+        // Malformed percent-encoding cannot name a file
+    }
+    if (!asset) {
+        res.writeHead(404, { 'Content-Type': 'text/html' });
+        res.end(notFoundPage(pathname));
+        return;
+    }
+    
+    // Pick the smallest encoding the client accepts
+    const encoding = AssetCache.negotiate(asset, req.headers['accept-encoding']);
+    const variant = asset.variants[encoding];
+    const headers = {
+        'Content-Type': asset.contentType,
+        'ETag': variant.etag,
+        'Cache-Control': CACHE_POLICIES[asset.ext] || DEFAULT_CACHE_POLICY,
+        'Vary': 'Accept-Encoding',
+        'Access-Control-Allow-Origin': '*',
+        'Access-Control-Allow-Methods': 'GET, POST, OPTIONS',
+        'Access-Control-Allow-Headers': 'Content-Type'
+    };
+    
+    // The client already has this exact representation
+    if (AssetCache.matches(req.headers['if-none-match'], variant.etag)) {
+        res.writeHead(304, headers);
+        res.end();
+        return;
+    }
+    
+    if (encoding !== 'identity') {
+        headers['Content-Encoding'] = encoding;
+    }
+    headers['Content-Length'] = variant.body.length;
+    res.writeHead(200, headers);
+    res.end(req.method === 'HEAD' ? undefined : variant.body);
 });
 
+// Keep idle browser connections open longer than typical proxy timeouts, so
+// the proxy never reuses a socket the server is closing
+server.keepAliveTimeout = KEEP_ALIVE_TIMEOUT_MS;
+server.headersTimeout = KEEP_ALIVE_TIMEOUT_MS + 1000;
+
 // Start server
+const assetCount = assets.load();
+assets.watch();
 server.listen(PORT, () => {
     console.log('🚀 Algorithm Visualizers Server Started!');
     console.log(`📍 Server running at: http://localhost:${PORT}`);
-    console.log(`📁 Serving files from: ${path.join(__dirname, DIRECTORY)}`);
+    console.log(`📁 Serving files from: ${path.join(__dirname, DIRECTORY)} (${assetCount} cached in memory)`);
     console.log('🌐 Available pages:');
     console.log(`   • Combined Interface: http://localhost:${PORT}/combined.html`);
     console.log(`   • Sorting Visualizer: http://localhost:${PORT}/index.html`);
     console.log(`   • Pathfinding Visualizer: http://localhost:${PORT}/pathfinding.html`);
+    console.log(`🔌 API requests proxied to routing daemon at: ${DAEMON_SOCKET}`);
     console.log('🔧 Press Ctrl+C to stop the server');
     console.log('-'.repeat(60));
     
-    // Try to open the combined interface in default browser (Windows compatible)
-    try {
-        const { exec } = require('child_process');
-        const platform = process.platform;
-        
-        let command;
-        if (platform === 'win32') {
-            command = `start http://localhost:${PORT}/combined.html`;
-        } else if (platform === 'darwin') {
-            command = `open http://localhost:${PORT}/combined.html`;
-        } else {
-            command = `xdg-open http://localhost:${PORT}/combined.html`;
-        }
-        
-        exec(command, (error) => {
-            if (error) {
-                console.log('⚠️  Could not open browser automatically');
-                console.log(`   Please manually open: http://localhost:${PORT}/combined.html`);
+    // Try to open the combined interface in default browser (Windows compatible);
+    // OPEN_BROWSER=0 skips this, e.g. for the static benchmark
+    if (process.env.OPEN_BROWSER !== '0') {
+        try {
+            const { exec } = require('child_process');
+            const platform = process.platform;
+            
+            let command;
+            if (platform === 'win32') {
+                command = `start http://localhost:${PORT}/combined.html`;
+            } else if (platform === 'darwin') {
+                command = `open http://localhost:${PORT}/combined.html`;
             } else {
-                console.log('✅ Opened combined interface in your default browser');
+                command = `xdg-open http://localhost:${PORT}/combined.html`;
             }
-        });
-    } catch (error) {
-        console.log('⚠️  Could not open browser automatically');
-        console.log(`   Please manually open: http://localhost:${PORT}/combined.html`);
+            
+            exec(command, (error) => {
+                if (error) {
+                    console.log('⚠️  Could not open browser automatically');
+                    console.log(`   Please manually open: http://localhost:${PORT}/combined.html`);
+                } else {
+                    console.log('✅ Opened combined interface in your default browser');
+                }
+            });
+        } catch (error) {
+            console.log('⚠️  Could not open browser automatically');
+            console.log(`   Please manually open: http://localhost:${PORT}/combined.html`);
+        }
     }
     
     console.log('-'.repeat(60));
@@ -141,10 +329,14 @@ server.listen(PORT, () => {
 // Handle server shutdown
 process.on('SIGINT', () => {
     console.log('\n🛑 Server stopped by user');
+    daemon.close();
+    assets.close();
     server.close(() => {
         console.log('✅ Server closed gracefully');
         process.exit(0);
     });
+    // Idle keep-alive sockets would otherwise hold close() open
+    if (server.closeIdleConnections) server.closeIdleConnections();
 });
 
 // Handle uncaught exceptions
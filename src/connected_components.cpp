@@ -0,0 +1,167 @@
+#include "connected_components.h"
+#include <atomic>
+#include <memory>
+#include <random>
+#include <unordered_map>
+
+namespace {
+
+// Neighbours hooked per node before the giant component is sampled
+const uint32_t NEIGHBOR_ROUNDS = 2;
+const size_t SAMPLE_SIZE = 1024;
+
+class ParentForest {
+private:
+    std::unique_ptr<std::atomic<NodeId>[]> parent;
+
+public:
+    ParentForest(size_t nodeCount, unsigned threads) : parent(new std::atomic<NodeId>[nodeCount]) {
+        parallelFor(nodeCount, threads, [&](size_t node, unsigned) {
+            parent[node].store(static_cast<NodeId>(node), std::memory_order_relaxed);
+        }, 4096);
+    }
+
+    // Root of node's tree, halving the path on the way up
+    NodeId find(NodeId node) {
+        while (true) {
+            NodeId up = parent[node].load(std::memory_order_relaxed);
+            if (up == node) return node;
+            NodeId grand = parent[up].load(std::memory_order_relaxed);
+            if (up != grand) {
+                // Losing this race only means somebody else shortened it
+                parent[node].compare_exchange_weak(up, grand, std::memory_order_relaxed);
+            }
+            node = grand;
+        }
+    }
+
+    void link(NodeId a, NodeId b) {
+        while (true) {
+            NodeId rootA = find(a);
+            NodeId rootB = find(b);
+            if (rootA == rootB) return;
+            if (rootA < rootB) std::swap(rootA, rootB);
+            // Hang the larger root under the smaller one; fails if rootA
+            // stopped being a root in the meantime, then retry from the top
+            NodeId expected = rootA;
+            if (parent[rootA].compare_exchange_strong(expected, rootB, std::memory_order_acq_rel)) return;
+        }
+    }
+
+    // Points every node straight at its root (run once linking is finished)
+    void compress(size_t nodeCount, unsigned threads) {
+        parallelFor(nodeCount, threads, [&](size_t node, unsigned) {
+            parent[node].store(find(static_cast<NodeId>(node)), std::memory_order_relaxed);
+        }, 4096);
+    }
+
+    NodeId rootOf(NodeId node) const { return parent[node].load(std::memory_order_relaxed); }
+};
+
+void linkAllEdges(const RoadGraph& graph, ParentForest& forest, unsigned threads) {
+    parallelFor(graph.nodeCount(), threads, [&](size_t i, unsigned) {
+        NodeId node = static_cast<NodeId>(i);
+        for (EdgeId e = graph.firstEdge(node); e < graph.endEdge(node); ++e) {
+            NodeId neighbor = graph.target(e);
+            // Undirected graphs store each road twice, link it once
+            if (graph.isDirected() || neighbor < node) {
+                forest.link(node, neighbor);
+            }
+        }
+    }, 1024);
+}
+
+void afforest(const RoadGraph& graph, ParentForest& forest, unsigned threads) {
+    size_t nodeCount = graph.nodeCount();
+    for (uint32_t round = 0; round < NEIGHBOR_ROUNDS; ++round) {
+        parallelFor(nodeCount, threads, [&](size_t i, unsigned) {
+            NodeId node = static_cast<NodeId>(i);
+            EdgeId e = graph.firstEdge(node) + round;
+            if (e < graph.endEdge(node)) {
+                forest.link(node, graph.target(e));
+            }
+        }, 1024);
+        forest.compress(nodeCount, threads);
+    }
+
+    // After sampling most of a road network already hangs off one root
+    std::mt19937 gen(nodeCount);
+    std::uniform_int_distribution<NodeId> pick(0, static_cast<NodeId>(nodeCount - 1));
+    std::unordered_map<NodeId, size_t> counts;
+    NodeId giant = forest.rootOf(0);
+    size_t best = 0;
+    for (size_t i = 0; i < SAMPLE_SIZE; ++i) {
+        NodeId root = forest.rootOf(pick(gen));
+        if (++counts[root] > best) {
+            best = counts[root];
+            giant = root;
+        }
+    }
+
+    // Nodes in the giant component are skipped: any edge leaving it is seen
+    // from its other end. Directed graphs keep each arc only at its tail, so
+    // the remaining nodes also walk their incoming arcs.
+    parallelFor(nodeCount, threads, [&](size_t i, unsigned) {
+        NodeId node = static_cast<NodeId>(i);
+        if (forest.find(node) == giant) {
+            return;
+        }
+        for (EdgeId e = graph.firstEdge(node) + NEIGHBOR_ROUNDS; e < graph.endEdge(node); ++e) {
+            forest.link(node, graph.target(e));
+        }
+        if (graph.isDirected()) {
+            for (EdgeId r = graph.firstReverseEdge(node); r < graph.endReverseEdge(node); ++r) {
+                forest.link(node, graph.reverseSource(r));
+            }
+        }
+    }, 1024);
+}
+
+} // namespace
+
+std::string componentAlgorithmName(ComponentAlgorithm algorithm) {
+    switch (algorithm) {
+        case ComponentAlgorithm::UnionFind: return "Union-Find";
+        case ComponentAlgorithm::Afforest:  return "Afforest";
+    }
+    return "Unknown";
+}
+
+NodeId ConnectedComponents::largestComponent() const {
+    if (sizes.empty()) {
+        return INVALID_NODE;
+    }
+    return static_cast<NodeId>(std::max_element(sizes.begin(), sizes.end()) - sizes.begin());
+}
+
+ConnectedComponents ConnectedComponents::compute(const RoadGraph& graph, ComponentAlgorithm algorithm,
+                                                 unsigned threads) {
+    ConnectedComponents components;
+    size_t nodeCount = graph.nodeCount();
+    if (nodeCount == 0) {
+        return components;
+    }
+
+    ParentForest forest(nodeCount, threads);
+    if (algorithm == ComponentAlgorithm::Afforest) {
+        afforest(graph, forest, threads);
+    } else {
+        linkAllEdges(graph, forest, threads);
+    }
+    forest.compress(nodeCount, threads);
+
+    // Every root is the smallest node of its component, so numbering roots
+    // in node order gives labels ordered by smallest member
+    components.label.resize(nodeCount);
+    for (NodeId node = 0; node < nodeCount; ++node) {
+        NodeId root = forest.rootOf(node);
+        if (root == node) {
+            components.label[node] = static_cast<NodeId>(components.sizes.size());
+            components.sizes.push_back(0);
+        }
+        NodeId id = components.label[root];
+        components.label[node] = id;
+        components.sizes[id]++;
+    }
+    return components;
+}
@@ -0,0 +1,39 @@
+#ifndef CONNECTED_COMPONENTS_H
+#define CONNECTED_COMPONENTS_H
+
+#include "road_graph.h"
+#include "parallel.h"
+#include <vector>
+#include <string>
+
+/**
+ * Parallel Connected Components
+ * Concurrent union-find over a shared parent array: roots are linked with a
+ * compare-and-swap (larger id under smaller, so no cycles can form) and finds
+ * halve paths as they go. Afforest runs the same linking in the order that
+ * makes it cheap on big graphs: hook a couple of neighbours per node, find
+ * the giant component by sampling, then process remaining edges only for
+ * nodes outside it. Arc direction is ignored (weakly connected components).
+ */
+
+enum class ComponentAlgorithm {
+    UnionFind, // every edge, one CAS link per edge
+    Afforest   // neighbour sampling, then skip the giant component
+};
+
+std::string componentAlgorithmName(ComponentAlgorithm algorithm);
+
+struct ConnectedComponents {
+    std::vector<NodeId> label; // per node, 0..componentCount()-1 ordered by each component's smallest node
+    std::vector<size_t> sizes; // nodes per component
+
+    size_t componentCount() const { return sizes.size(); }
+    // Component with the most nodes (the first such), INVALID_NODE for an empty graph
+    NodeId largestComponent() const;
+
+    static ConnectedComponents compute(const RoadGraph& graph,
+                                       ComponentAlgorithm algorithm = ComponentAlgorithm::Afforest,
+                                       unsigned threads = defaultThreadCount());
+};
+
+#endif // CONNECTED_COMPONENTS_H
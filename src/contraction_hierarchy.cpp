@@ -0,0 +1,681 @@
+#include "contraction_hierarchy.h"
+#include "parallel.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <cstring>
+
+namespace {
+
+const char CH_MAGIC[4] = {'S', 'V', 'C', 'H'};
+const uint32_t CH_FORMAT_VERSION = 2; // 2: source graph fingerprint
+
+struct DynamicArc {
+    NodeId node;
+    double weight;
+    EdgeId edge;
+};
+
+struct Shortcut {
+    NodeId from;
+    NodeId to;
+    double weight;
+    EdgeId firstHalf;
+    EdgeId secondHalf;
+};
+
+// Bounded local Dijkstra that ignores the node being contracted (and any node
+// flagged in `blocked`) and stops once every target is settled, the cost
+// bound is passed or the settle limit hit
+struct WitnessSearch {
+    std::vector<double> dist;
+    std::vector<uint32_t> stamp;
+    std::vector<uint32_t> targetStamp;
+    uint32_t currentStamp = 0;
+    IndexedDaryHeap<double, 4> queue;
+    std::vector<DynamicArc> targets; // scratch for symmetric simulation
+
+    void resize(size_t nodeCount) {
+        dist.assign(nodeCount, INFINITE_WEIGHT);
+        stamp.assign(nodeCount, 0);
+        targetStamp.assign(nodeCount, 0);
+        queue.reserve(nodeCount);
+    }
+
+    double distanceTo(NodeId node) const { return stamp[node] == currentStamp ? dist[node] : INFINITE_WEIGHT; }
+
+    void run(const std::vector<std::vector<DynamicArc>>& out, NodeId source, NodeId excluded,
+             const std::vector<char>& blocked, const std::vector<DynamicArc>& targets, double maxCost,
+             size_t settleLimit) {
+        if (++currentStamp == 0) {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            std::fill(targetStamp.begin(), targetStamp.end(), 0);
+            currentStamp = 1;
+        }
+        size_t targetsLeft = 0;
+        for (const auto& target : targets) {
+            if (target.node != source && targetStamp[target.node] != currentStamp) {
+                targetStamp[target.node] = currentStamp;
+                targetsLeft++;
+            }
+        }
+
+        queue.clear();
+        stamp[source] = currentStamp;
+        dist[source] = 0.0;
+        queue.push(source, 0.0);
+
+        size_t settledNodes = 0;
+        while (!queue.empty() && targetsLeft > 0) {
+            HeapEntry<double> top = queue.pop();
+            if (top.key > maxCost || ++settledNodes > settleLimit) {
+                break;
+            }
+            if (targetStamp[top.node] == currentStamp) {
+                targetsLeft--;
+            }
+            for (const auto& arc : out[top.node]) {
+                if (arc.node == excluded || blocked[arc.node]) continue;
+                double newDistance = top.key + arc.weight;
+                if (stamp[arc.node] != currentStamp || newDistance < dist[arc.node]) {
+                    stamp[arc.node] = currentStamp;
+                    dist[arc.node] = newDistance;
+                    queue.push(arc.node, newDistance);
+                }
+            }
+        }
+    }
+};
+
+class HierarchyBuilder {
+private:
+    const ChBuildOptions& options;
+    size_t nodeCount;
+    bool symmetric; // undirected input: every shortcut u -> w has a twin w -> u
+    std::vector<std::vector<DynamicArc>> out;
+    std::vector<std::vector<DynamicArc>> in;
+    std::vector<char> contracted;
+    std::vector<char> inBatch; // nodes of the batch being contracted, off limits to witnesses
+    std::vector<NodeId> claim;  // best batch node next to each node, INVALID_NODE outside separateBatch
+    std::vector<NodeId> separated;
+    std::vector<uint32_t> contractedNeighbors;
+    std::vector<uint32_t> level;
+    std::vector<int64_t> priority;
+    std::vector<WitnessSearch> witness; // one per thread
+
+public:
+    std::vector<ChEdge> edges;
+    std::vector<uint32_t> ranks;
+    std::vector<std::vector<ChArc>> up;
+    std::vector<std::vector<ChArc>> down;
+
+    HierarchyBuilder(const RoadGraph& graph, const ChBuildOptions& opts)
+        : options(opts), nodeCount(graph.nodeCount()), symmetric(!graph.isDirected()), out(nodeCount), in(nodeCount),
+          contracted(nodeCount, 0), inBatch(nodeCount, 0), claim(nodeCount, INVALID_NODE),
+          contractedNeighbors(nodeCount, 0), level(nodeCount, 0), priority(nodeCount, 0),
+          witness(std::max(1u, opts.threads)), ranks(nodeCount, 0), up(nodeCount), down(nodeCount) {
+        for (NodeId node = 0; node < nodeCount; ++node) {
+            for (EdgeId e = graph.firstEdge(node); e < graph.endEdge(node); ++e) {
+                NodeId target = graph.target(e);
+                if (target == node) continue; // self loops never lie on shortest paths
+                ChEdge edge;
+                edge.from = node;
+                edge.to = target;
+                edge.weight = graph.weight(e, options.metric);
+                edge.original = e;
+                edges.push_back(edge);
+                EdgeId id = static_cast<EdgeId>(edges.size() - 1);
+                out[node].push_back({target, edge.weight, id});
+                in[target].push_back({node, edge.weight, id});
+            }
+        }
+        for (auto& search : witness) {
+            search.resize(nodeCount);
+        }
+    }
+
+    static const DynamicArc* findArc(const std::vector<DynamicArc>& arcs, NodeId node) {
+        for (const auto& arc : arcs) {
+            if (arc.node == node) return &arc;
+        }
+        return nullptr;
+    }
+
+    // Shortcuts needed to contract `node` with the current remaining graph
+    void simulate(NodeId node, WitnessSearch& search, std::vector<Shortcut>& shortcuts, size_t settleLimit) {
+        shortcuts.clear();
+        if (symmetric) {
+            simulateSymmetric(node, search, shortcuts, settleLimit);
+            return;
+        }
+
+        double maxOut = 0.0;
+        for (const auto& arc : out[node]) maxOut = std::max(maxOut, arc.weight);
+
+        for (const auto& incoming : in[node]) {
+            search.run(out, incoming.node, node, inBatch, out[node], incoming.weight + maxOut, settleLimit);
+            for (const auto& outgoing : out[node]) {
+                if (outgoing.node == incoming.node) continue;
+                double via = incoming.weight + outgoing.weight;
+                if (search.distanceTo(outgoing.node) > via) {
+                    shortcuts.push_back({incoming.node, outgoing.node, via, incoming.edge, outgoing.edge});
+                }
+            }
+        }
+    }
+
+    // Witness u -> w exists exactly when w -> u does, so only pairs with
+    // u < w are searched and each missing witness yields both shortcuts
+    void simulateSymmetric(NodeId node, WitnessSearch& search, std::vector<Shortcut>& shortcuts, size_t settleLimit) {
+        for (const auto& incoming : in[node]) {
+            search.targets.clear();
+            double maxOut = 0.0;
+            for (const auto& outgoing : out[node]) {
+                if (outgoing.node > incoming.node) {
+                    search.targets.push_back(outgoing);
+                    maxOut = std::max(maxOut, outgoing.weight);
+                }
+            }
+            if (search.targets.empty()) continue;
+
+            search.run(out, incoming.node, node, inBatch, search.targets, incoming.weight + maxOut, settleLimit);
+            for (const auto& outgoing : search.targets) {
+                double via = incoming.weight + outgoing.weight;
+                if (search.distanceTo(outgoing.node) > via) {
+                    const DynamicArc* twinIn = findArc(in[node], outgoing.node);
+                    const DynamicArc* twinOut = findArc(out[node], incoming.node);
+                    shortcuts.push_back({incoming.node, outgoing.node, via, incoming.edge, outgoing.edge});
+                    shortcuts.push_back({outgoing.node, incoming.node, via, twinIn->edge, twinOut->edge});
+                }
+            }
+        }
+    }
+
+    // Edge difference from a cheaper simulated contraction, plus the
+    // contracted neighbor count and hierarchy depth to spread contraction evenly
+    int64_t computePriority(NodeId node, WitnessSearch& search, std::vector<Shortcut>& scratch) {
+        simulate(node, search, scratch, std::max<size_t>(1, options.witnessSettleLimit / 16));
+        int64_t edgeDifference = static_cast<int64_t>(scratch.size())
+                               - static_cast<int64_t>(in[node].size() + out[node].size());
+        return 4 * edgeDifference + 2 * contractedNeighbors[node] + level[node];
+    }
+
+    void updatePriorities(const std::vector<NodeId>& nodes) {
+        std::vector<std::vector<Shortcut>> scratch(witness.size());
+        parallelFor(nodes.size(), options.threads, [&](size_t i, unsigned thread) {
+            priority[nodes[i]] = computePriority(nodes[i], witness[thread], scratch[thread]);
+        }, 16);
+    }
+
+    bool beats(NodeId node, NodeId other) const {
+        return priority[node] < priority[other] || (priority[node] == priority[other] && node < other);
+    }
+
+    // Local minima of (priority, id) form an independent set, so their
+    // shortcuts can be computed concurrently against the same graph
+    bool isLocalMinimum(NodeId node) const {
+        for (const auto& arc : out[node]) if (beats(arc.node, node)) return false;
+        for (const auto& arc : in[node]) if (beats(arc.node, node)) return false;
+        return true;
+    }
+
+    // Keeps only batch nodes that share no neighbor with a better one. Two
+    // nodes with a common neighbor can be each other's only witness; searched
+    // on the same graph, both would drop a shortcut
+    void separateBatch(std::vector<NodeId>& batch) {
+        auto claimAll = [&](NodeId node, const std::vector<DynamicArc>& arcs) {
+            for (const auto& arc : arcs) {
+                if (claim[arc.node] == INVALID_NODE || beats(node, claim[arc.node])) claim[arc.node] = node;
+            }
+        };
+        auto ownsAll = [&](NodeId node, const std::vector<DynamicArc>& arcs) {
+            for (const auto& arc : arcs) if (claim[arc.node] != node) return false;
+            return true;
+        };
+        for (NodeId node : batch) {
+            claimAll(node, out[node]);
+            claimAll(node, in[node]);
+        }
+        separated.clear();
+        for (NodeId node : batch) {
+            if (ownsAll(node, out[node]) && ownsAll(node, in[node])) separated.push_back(node);
+        }
+        for (NodeId node : batch) {
+            for (const auto& arc : out[node]) claim[arc.node] = INVALID_NODE;
+            for (const auto& arc : in[node]) claim[arc.node] = INVALID_NODE;
+        }
+        batch.swap(separated);
+    }
+
+    void addOrImprove(std::vector<DynamicArc>& arcs, NodeId node, double weight, EdgeId edge) {
+        for (auto& arc : arcs) {
+            if (arc.node == node) {
+                if (weight < arc.weight) {
+                    arc.weight = weight;
+                    arc.edge = edge;
+                }
+                return;
+            }
+        }
+        arcs.push_back({node, weight, edge});
+    }
+
+    void contract(NodeId node, uint32_t rank, const std::vector<Shortcut>& shortcuts) {
+        ranks[node] = rank;
+        contracted[node] = 1;
+
+        for (const auto& arc : out[node]) {
+            up[node].push_back({arc.node, arc.weight, arc.edge});
+        }
+        for (const auto& arc : in[node]) {
+            down[node].push_back({arc.node, arc.weight, arc.edge});
+        }
+
+        auto removeNode = [node](std::vector<DynamicArc>& arcs) {
+            arcs.erase(std::remove_if(arcs.begin(), arcs.end(),
+                                      [node](const DynamicArc& arc) { return arc.node == node; }), arcs.end());
+        };
+        for (const auto& arc : out[node]) {
+            removeNode(in[arc.node]);
+            contractedNeighbors[arc.node]++;
+            level[arc.node] = std::max(level[arc.node], level[node] + 1);
+        }
+        for (const auto& arc : in[node]) {
+            removeNode(out[arc.node]);
+            contractedNeighbors[arc.node]++;
+            level[arc.node] = std::max(level[arc.node], level[node] + 1);
+        }
+
+        for (const auto& shortcut : shortcuts) {
+            ChEdge edge;
+            edge.from = shortcut.from;
+            edge.to = shortcut.to;
+            edge.weight = shortcut.weight;
+            edge.firstHalf = shortcut.firstHalf;
+            edge.secondHalf = shortcut.secondHalf;
+            edges.push_back(edge);
+            EdgeId id = static_cast<EdgeId>(edges.size() - 1);
+            addOrImprove(out[shortcut.from], shortcut.to, shortcut.weight, id);
+            addOrImprove(in[shortcut.to], shortcut.from, shortcut.weight, id);
+        }
+
+        out[node].clear();
+        out[node].shrink_to_fit();
+        in[node].clear();
+        in[node].shrink_to_fit();
+    }
+
+    void run() {
+        std::vector<NodeId> remaining(nodeCount);
+        for (NodeId node = 0; node < nodeCount; ++node) remaining[node] = node;
+        updatePriorities(remaining);
+
+        uint32_t nextRank = 0;
+        std::vector<NodeId> batch;
+        std::vector<std::vector<Shortcut>> batchShortcuts;
+        std::vector<NodeId> touched;
+        std::vector<char> touchedFlag(nodeCount, 0);
+
+        while (!remaining.empty()) {
+            batch.clear();
+            for (NodeId node : remaining) {
+                if (isLocalMinimum(node)) batch.push_back(node);
+            }
+            separateBatch(batch);
+            // Witnesses further out must not run through another batch node
+            // either, since it disappears in the same round
+            for (NodeId node : batch) inBatch[node] = 1;
+
+            batchShortcuts.resize(batch.size());
+            parallelFor(batch.size(), options.threads, [&](size_t i, unsigned thread) {
+                simulate(batch[i], witness[thread], batchShortcuts[i], options.witnessSettleLimit);
+            }, 16);
+
+            touched.clear();
+            for (size_t i = 0; i < batch.size(); ++i) {
+                for (const auto& arc : out[batch[i]]) {
+                    if (!touchedFlag[arc.node]) { touchedFlag[arc.node] = 1; touched.push_back(arc.node); }
+                }
+                for (const auto& arc : in[batch[i]]) {
+                    if (!touchedFlag[arc.node]) { touchedFlag[arc.node] = 1; touched.push_back(arc.node); }
+                }
+                contract(batch[i], nextRank++, batchShortcuts[i]);
+            }
+            for (NodeId node : batch) inBatch[node] = 0;
+
+            remaining.erase(std::remove_if(remaining.begin(), remaining.end(),
+                                           [this](NodeId node) { return contracted[node] != 0; }), remaining.end());
+            touched.erase(std::remove_if(touched.begin(), touched.end(),
+                                         [this](NodeId node) { return contracted[node] != 0; }), touched.end());
+            for (NodeId node : touched) touchedFlag[node] = 0;
+            updatePriorities(touched);
+        }
+    }
+};
+
+template <typename T>
+void writeVector(std::ofstream& file, const std::vector<T>& values) {
+    uint64_t size = values.size();
+    file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    file.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(size * sizeof(T)));
+}
+
+template <typename T>
+bool readVector(std::ifstream& file, std::vector<T>& values) {
+    uint64_t size = 0;
+    if (!file.read(reinterpret_cast<char*>(&size), sizeof(size))) return false;
+    // Reject sizes past the end of the file before allocating for them
+    std::streampos here = file.tellg();
+    file.seekg(0, std::ios::end);
+    uint64_t remaining = static_cast<uint64_t>(file.tellg() - here);
+    file.seekg(here);
+    if (size > remaining / sizeof(T)) return false;
+    values.resize(size);
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(values.data()),
+                                       static_cast<std::streamsize>(size * sizeof(T))));
+}
+
+void flatten(const std::vector<std::vector<ChArc>>& lists, std::vector<EdgeId>& offsets, std::vector<ChArc>& arcs) {
+    offsets.assign(lists.size() + 1, 0);
+    arcs.clear();
+    for (size_t node = 0; node < lists.size(); ++node) {
+        arcs.insert(arcs.end(), lists[node].begin(), lists[node].end());
+        offsets[node + 1] = static_cast<EdgeId>(arcs.size());
+    }
+}
+
+} // namespace
+
+ChBuildOptions::ChBuildOptions()
+    : metric(Metric::Distance), threads(defaultThreadCount()), witnessSettleLimit(500) {}
+
+ContractionHierarchy::ContractionHierarchy() : metric(Metric::Distance), graphEdges(0), graphChecksum(0) {}
+
+// FNV-1a over the CSR layout (arc counts, targets) and the metric's weight bits
+uint64_t ContractionHierarchy::checksum(const RoadGraph& graph, Metric metric) {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](uint64_t value) {
+        for (int byte = 0; byte < 8; ++byte) {
+            hash = (hash ^ ((value >> (8 * byte)) & 0xff)) * 1099511628211ull;
+        }
+    };
+    mix(graph.nodeCount());
+    mix(graph.isDirected() ? 1 : 0);
+    for (NodeId node = 0; node < graph.nodeCount(); ++node) {
+        mix(graph.endEdge(node));
+    }
+    for (EdgeId e = 0; e < graph.edgeCount(); ++e) {
+        double weight = graph.weight(e, metric);
+        uint64_t bits = 0;
+        std::memcpy(&bits, &weight, sizeof(bits));
+        mix(graph.target(e));
+        mix(bits);
+    }
+    return hash;
+}
+
+bool ContractionHierarchy::matches(const RoadGraph& graph) const {
+    if (graph.nodeCount() != nodeCount() || graph.edgeCount() != graphEdges ||
+        checksum(graph, metric) != graphChecksum) {
+        return false;
+    }
+    for (const ChEdge& edge : edges) {
+        if (!edge.isShortcut() && graph.findEdge(edge.from, edge.to) != edge.original) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Everything a query or unpack dereferences must stay inside its array;
+// shortcut halves always precede the shortcut, which also rules out cycles
+bool ContractionHierarchy::indicesValid() const {
+    size_t nodes = ranks.size();
+    for (uint32_t rank : ranks) {
+        if (rank >= nodes) return false;
+    }
+    for (size_t i = 0; i < edges.size(); ++i) {
+        const ChEdge& edge = edges[i];
+        if (edge.from >= nodes || edge.to >= nodes) return false;
+        if (edge.isShortcut() ? edge.firstHalf >= i || edge.secondHalf >= i : edge.original >= graphEdges) {
+            return false;
+        }
+    }
+    auto arcsValid = [&](const std::vector<EdgeId>& offsets, const std::vector<ChArc>& arcs) {
+        if (offsets.size() != nodes + 1 || offsets.front() != 0 || offsets.back() != arcs.size()) return false;
+        for (size_t node = 0; node < nodes; ++node) {
+            if (offsets[node] > offsets[node + 1]) return false;
+        }
+        for (const ChArc& arc : arcs) {
+            if (arc.node >= nodes || arc.edge >= edges.size()) return false;
+        }
+        return true;
+    };
+    return arcsValid(upOffsets, upArcs) && arcsValid(downOffsets, downArcs);
+}
+
+ContractionHierarchy ContractionHierarchy::build(const RoadGraph& graph, const ChBuildOptions& options) {
+    HierarchyBuilder builder(graph, options);
+    builder.run();
+
+    ContractionHierarchy ch;
+    ch.metric = options.metric;
+    ch.graphEdges = graph.edgeCount();
+    ch.graphChecksum = checksum(graph, options.metric);
+    ch.ranks = std::move(builder.ranks);
+    ch.edges = std::move(builder.edges);
+    flatten(builder.up, ch.upOffsets, ch.upArcs);
+    flatten(builder.down, ch.downOffsets, ch.downArcs);
+    return ch;
+}
+
+size_t ContractionHierarchy::shortcutCount() const {
+    return static_cast<size_t>(std::count_if(edges.begin(), edges.end(),
+                                             [](const ChEdge& edge) { return edge.isShortcut(); }));
+}
+
+void ContractionHierarchy::unpackEdge(EdgeId edge, std::vector<NodeId>& nodes) const {
+    std::vector<EdgeId> stack = {edge};
+    while (!stack.empty()) {
+        const ChEdge& current = edges[stack.back()];
+        stack.pop_back();
+        if (current.isShortcut()) {
+            stack.push_back(current.secondHalf);
+            stack.push_back(current.firstHalf);
+        } else {
+            nodes.push_back(current.to);
+        }
+    }
+}
+
+bool ContractionHierarchy::save(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error opening hierarchy file: " << filename << std::endl;
+        return false;
+    }
+
+    uint8_t metricTag = metric == Metric::Distance ? 0 : 1;
+    file.write(CH_MAGIC, sizeof(CH_MAGIC));
+    file.write(reinterpret_cast<const char*>(&CH_FORMAT_VERSION), sizeof(CH_FORMAT_VERSION));
+    file.write(reinterpret_cast<const char*>(&metricTag), sizeof(metricTag));
+    file.write(reinterpret_cast<const char*>(&graphEdges), sizeof(graphEdges));
+    file.write(reinterpret_cast<const char*>(&graphChecksum), sizeof(graphChecksum));
+    writeVector(file, ranks);
+    writeVector(file, edges);
+    writeVector(file, upOffsets);
+    writeVector(file, upArcs);
+    writeVector(file, downOffsets);
+    writeVector(file, downArcs);
+    return static_cast<bool>(file);
+}
+
+bool ContractionHierarchy::load(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error opening hierarchy file: " << filename << std::endl;
+        return false;
+    }
+
+    char magic[4];
+    uint32_t version = 0;
+    uint8_t metricTag = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&metricTag), sizeof(metricTag));
+    if (!file || std::memcmp(magic, CH_MAGIC, sizeof(magic)) != 0 || version != CH_FORMAT_VERSION) {
+        std::cerr << "Unsupported hierarchy file: " << filename << std::endl;
+        return false;
+    }
+
+    ContractionHierarchy loaded;
+    loaded.metric = metricTag == 0 ? Metric::Distance : Metric::Time;
+    file.read(reinterpret_cast<char*>(&loaded.graphEdges), sizeof(loaded.graphEdges));
+    file.read(reinterpret_cast<char*>(&loaded.graphChecksum), sizeof(loaded.graphChecksum));
+    if (!file || metricTag > 1 || !readVector(file, loaded.ranks) || !readVector(file, loaded.edges) ||
+        !readVector(file, loaded.upOffsets) || !readVector(file, loaded.upArcs) ||
+        !readVector(file, loaded.downOffsets) || !readVector(file, loaded.downArcs) || !loaded.indicesValid()) {
+        std::cerr << "Corrupt hierarchy file: " << filename << std::endl;
+        return false;
+    }
+
+    *this = std::move(loaded);
+    return true;
+}
+
+size_t ContractionHierarchy::memoryUsage() const {
+    return ranks.capacity() * sizeof(uint32_t) + edges.capacity() * sizeof(ChEdge)
+         + (upOffsets.capacity() + downOffsets.capacity()) * sizeof(EdgeId)
+         + (upArcs.capacity() + downArcs.capacity()) * sizeof(ChArc);
+}
+
+ChQuery::ChQuery()
+    : currentStamp(0), sourceNode(INVALID_NODE), meetingNode(INVALID_NODE),
+      bestDistance(INFINITE_WEIGHT), settled(0), relaxed(0) {}
+
+void ChQuery::prepare(size_t nodeCount) {
+    if (forward.stamp.size() != nodeCount) {
+        for (Side* side : {&forward, &backward}) {
+            side->dist.assign(nodeCount, INFINITE_WEIGHT);
+            side->parentEdge.assign(nodeCount, INVALID_EDGE);
+            side->stamp.assign(nodeCount, 0);
+            side->queue.reserve(nodeCount);
+        }
+        currentStamp = 0;
+    }
+    if (++currentStamp == 0) {
+        std::fill(forward.stamp.begin(), forward.stamp.end(), 0);
+        std::fill(backward.stamp.begin(), backward.stamp.end(), 0);
+        currentStamp = 1;
+    }
+    forward.queue.clear();
+    backward.queue.clear();
+    meetingNode = INVALID_NODE;
+    bestDistance = INFINITE_WEIGHT;
+    settled = 0;
+    relaxed = 0;
+    queueStats.reset();
+}
+
+void ChQuery::run(const ContractionHierarchy& ch, NodeId source, NodeId target) {
+    prepare(ch.nodeCount());
+    sourceNode = source;
+
+    forward.stamp[source] = currentStamp;
+    forward.dist[source] = 0.0;
+    forward.parentEdge[source] = INVALID_EDGE;
+    forward.queue.push(source, 0.0);
+    backward.stamp[target] = currentStamp;
+    backward.dist[target] = 0.0;
+    backward.parentEdge[target] = INVALID_EDGE;
+    backward.queue.push(target, 0.0);
+    queueStats.countPush(2);
+
+    bool isForward = true;
+    while (true) {
+        bool forwardDone = forward.queue.empty() || forward.queue.top().key >= bestDistance;
+        bool backwardDone = backward.queue.empty() || backward.queue.top().key >= bestDistance;
+        if (forwardDone && backwardDone) {
+            break;
+        }
+        if (forwardDone) isForward = false;
+        if (backwardDone) isForward = true;
+
+        Side& side = isForward ? forward : backward;
+        Side& other = isForward ? backward : forward;
+        HeapEntry<double> top = side.queue.pop();
+        queueStats.countPop();
+        NodeId current = top.node;
+        settled++;
+
+        if (reached(other, current) && top.key + other.dist[current] < bestDistance) {
+            bestDistance = top.key + other.dist[current];
+            meetingNode = current;
+        }
+
+        // Stall-on-demand: a higher node already offers a shorter way in
+        bool stalled = false;
+        EdgeId stallBegin = isForward ? ch.firstDownArc(current) : ch.firstUpArc(current);
+        EdgeId stallEnd = isForward ? ch.endDownArc(current) : ch.endUpArc(current);
+        for (EdgeId a = stallBegin; a < stallEnd && !stalled; ++a) {
+            const ChArc& arc = isForward ? ch.downArc(a) : ch.upArc(a);
+            if (reached(side, arc.node) && side.dist[arc.node] + arc.weight < top.key) {
+                stalled = true;
+            }
+        }
+
+        if (!stalled) {
+            EdgeId begin = isForward ? ch.firstUpArc(current) : ch.firstDownArc(current);
+            EdgeId end = isForward ? ch.endUpArc(current) : ch.endDownArc(current);
+            for (EdgeId a = begin; a < end; ++a) {
+                const ChArc& arc = isForward ? ch.upArc(a) : ch.downArc(a);
+                double newDistance = top.key + arc.weight;
+                relaxed++;
+                if (!reached(side, arc.node) || newDistance < side.dist[arc.node]) {
+                    side.stamp[arc.node] = currentStamp;
+                    side.dist[arc.node] = newDistance;
+                    side.parentEdge[arc.node] = arc.edge;
+                    side.queue.push(arc.node, newDistance);
+                    queueStats.countPush(forward.queue.size() + backward.queue.size());
+                }
+            }
+        }
+
+        isForward = !isForward;
+    }
+}
+
+SearchStats ChQuery::searchStats() const {
+    SearchStats stats = queueStats;
+    stats.settled = settled;
+    stats.relaxed = relaxed;
+    return stats;
+}
+
+std::vector<NodeId> ChQuery::path(const ContractionHierarchy& ch) const {
+    std::vector<NodeId> nodes;
+    if (meetingNode == INVALID_NODE) {
+        return nodes;
+    }
+
+    // CH edges from the source up to the meeting node
+    std::vector<EdgeId> upward;
+    for (NodeId current = meetingNode; forward.parentEdge[current] != INVALID_EDGE;) {
+        EdgeId edge = forward.parentEdge[current];
+        upward.push_back(edge);
+        current = ch.edgeAt(edge).from;
+    }
+
+    nodes.push_back(sourceNode);
+    for (size_t i = upward.size(); i-- > 0;) {
+        ch.unpackEdge(upward[i], nodes);
+    }
+
+    // ... and from the meeting node down to the target
+    for (NodeId current = meetingNode; backward.parentEdge[current] != INVALID_EDGE;) {
+        EdgeId edge = backward.parentEdge[current];
+        ch.unpackEdge(edge, nodes);
+        current = ch.edgeAt(edge).to;
+    }
+    return nodes;
+}
@@ -0,0 +1,133 @@
+#ifndef CONTRACTION_HIERARCHY_H
+#define CONTRACTION_HIERARCHY_H
+
+#include "road_graph.h"
+#include "priority_queues.h"
+#include "search_stats.h"
+#include <vector>
+#include <string>
+
+/**
+ * Contraction Hierarchies
+ * Nodes are contracted one at a time (least important first) and shortcuts
+ * are added wherever a witness search finds no alternative path. Queries run
+ * a bidirectional Dijkstra that only climbs towards higher-ranked nodes.
+ */
+
+struct ChEdge {
+    NodeId from;
+    NodeId to;
+    double weight;
+    EdgeId original;   // RoadGraph edge for original edges, INVALID_EDGE for shortcuts
+    EdgeId firstHalf;  // shortcut from -> middle (CH edge id)
+    EdgeId secondHalf; // shortcut middle -> to (CH edge id)
+
+    ChEdge() : from(INVALID_NODE), to(INVALID_NODE), weight(0.0),
+               original(INVALID_EDGE), firstHalf(INVALID_EDGE), secondHalf(INVALID_EDGE) {}
+
+    bool isShortcut() const { return original == INVALID_EDGE; }
+};
+
+struct ChArc {
+    NodeId node;     // higher-ranked neighbor
+    double weight;
+    EdgeId edge;     // CH edge id
+};
+
+struct ChBuildOptions {
+    Metric metric;
+    unsigned threads;
+    size_t witnessSettleLimit; // bound on each witness search
+
+    ChBuildOptions();
+};
+
+class ContractionHierarchy {
+private:
+    Metric metric;
+    std::vector<uint32_t> ranks;
+    std::vector<ChEdge> edges;
+    // upward[v]: v -> higher node; downward[v]: higher node -> v (searched backwards)
+    std::vector<EdgeId> upOffsets;
+    std::vector<ChArc> upArcs;
+    std::vector<EdgeId> downOffsets;
+    std::vector<ChArc> downArcs;
+    // Source graph identity: arc count and a checksum of the arc layout and
+    // the metric's weights, so a saved hierarchy only loads onto its own graph
+    uint64_t graphEdges;
+    uint64_t graphChecksum;
+
+    static uint64_t checksum(const RoadGraph& graph, Metric metric);
+    bool indicesValid() const;
+
+public:
+    ContractionHierarchy();
+
+    static ContractionHierarchy build(const RoadGraph& graph, const ChBuildOptions& options = ChBuildOptions());
+
+    bool empty() const { return ranks.empty(); }
+    size_t nodeCount() const { return ranks.size(); }
+    size_t shortcutCount() const;
+    Metric getMetric() const { return metric; }
+    uint32_t rank(NodeId node) const { return ranks[node]; }
+    const ChEdge& edgeAt(EdgeId edge) const { return edges[edge]; }
+
+    EdgeId firstUpArc(NodeId node) const { return upOffsets[node]; }
+    EdgeId endUpArc(NodeId node) const { return upOffsets[node + 1]; }
+    const ChArc& upArc(EdgeId arc) const { return upArcs[arc]; }
+    EdgeId firstDownArc(NodeId node) const { return downOffsets[node]; }
+    EdgeId endDownArc(NodeId node) const { return downOffsets[node + 1]; }
+    const ChArc& downArc(EdgeId arc) const { return downArcs[arc]; }
+
+    // Expand a CH edge into the original node sequence, appending everything after `from`
+    void unpackEdge(EdgeId edge, std::vector<NodeId>& nodes) const;
+
+    // True when built from this exact graph (same arcs and metric weights)
+    bool matches(const RoadGraph& graph) const;
+
+    // Binary snapshot of the hierarchy; false on I/O error, format mismatch
+    // or any node, arc or edge index out of range
+    bool save(const std::string& filename) const;
+    bool load(const std::string& filename);
+
+    size_t memoryUsage() const;
+};
+
+// Reusable query workspace; one per thread, the hierarchy itself is read-only
+class ChQuery {
+private:
+    struct Side {
+        std::vector<double> dist;
+        std::vector<EdgeId> parentEdge;
+        std::vector<uint32_t> stamp;
+        IndexedDaryHeap<double, 4> queue;
+    };
+
+    Side forward;
+    Side backward;
+    uint32_t currentStamp;
+    NodeId sourceNode;
+    NodeId meetingNode;
+    double bestDistance;
+    size_t settled;
+    size_t relaxed;
+    SearchStats queueStats;
+
+    void prepare(size_t nodeCount);
+    bool reached(const Side& side, NodeId node) const { return side.stamp[node] == currentStamp; }
+
+public:
+    ChQuery();
+
+    void run(const ContractionHierarchy& ch, NodeId source, NodeId target);
+
+    double distance() const { return bestDistance; }
+    size_t settledCount() const { return settled; }
+    size_t relaxedCount() const { return relaxed; }
+    SearchStats searchStats() const;
+
+    // Unpacked node sequence source..target, empty when unreachable
+    std::vector<NodeId> path(const ContractionHierarchy& ch) const;
+};
+
+#endif // CONTRACTION_HIERARCHY_H
@@ -0,0 +1,280 @@
+#include "daemon_protocol.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <thread>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/**
+ * Routing Daemon Load Generator
+ * Opens several connections to a running routing_daemon and keeps `depth`
+ * requests in flight on each, so the daemon sees pipelined traffic the way
+ * the web server's connection pool produces it. Reports throughput and
+ * per-request latency percentiles (send to matching response).
+ * Usage: daemon_loadgen [--socket PATH] [--connections N] [--depth N]
+ *                       [--requests N] [--mix route|matrix|sort|mixed]
+ */
+
+using Clock = std::chrono::steady_clock;
+
+struct LoadResult {
+    std::vector<double> latencyMicros;
+    size_t errors;
+    bool failed;
+
+    LoadResult() : errors(0), failed(false) {}
+};
+
+static int connectTo(const std::string& path) {
+    sockaddr_un address;
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Socket path too long: " << path << std::endl;
+        return -1;
+    }
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        std::cerr << "Error connecting to " << path << ": " << std::strerror(errno) << std::endl;
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static bool sendAll(int fd, const std::vector<uint8_t>& bytes) {
+    size_t offset = 0;
+    while (offset < bytes.size()) {
+        ssize_t sent = send(fd, bytes.data() + offset, bytes.size() - offset, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) return false;
+        offset += sent;
+    }
+    return true;
+}
+
+static bool receiveAll(int fd, uint8_t* data, size_t size) {
+    size_t offset = 0;
+    while (offset < size) {
+        ssize_t received = recv(fd, data + offset, size - offset, 0);
+        if (received < 0 && errno == EINTR) continue;
+        if (received <= 0) return false;
+        offset += received;
+    }
+    return true;
+}
+
+// Reads one whole response frame
+static bool receiveFrame(int fd, FrameHeader& header, std::vector<uint8_t>& payload) {
+    uint8_t raw[FRAME_HEADER_SIZE];
+    if (!receiveAll(fd, raw, sizeof(raw))) {
+        return false;
+    }
+    header = FrameReader::header(raw);
+    payload.resize(header.length);
+    return receiveAll(fd, payload.data(), payload.size());
+}
+
+static void writeRequest(FrameWriter& writer, uint32_t requestId, const std::string& mix, uint32_t nodes,
+                         std::mt19937& rng) {
+    std::string kind = mix;
+    if (mix == "mixed") {
+        // Mostly routes, like the web front end
+        uint32_t roll = rng() % 10;
+        kind = roll < 7 ? "route" : roll < 9 ? "matrix" : "sort";
+    }
+    std::uniform_int_distribution<uint32_t> pickNode(0, nodes - 1);
+
+    if (kind == "matrix") {
+        writer.begin(FrameHeader(requestId, FrameType::Matrix));
+        writer.u8(0);
+        writer.u32(4);
+        writer.u32(4);
+        for (int i = 0; i < 8; ++i) {
+            writer.u8(static_cast<uint8_t>(NodeRefKind::Id));
+            writer.u32(pickNode(rng));
+        }
+    } else if (kind == "sort") {
+        writer.begin(FrameHeader(requestId, FrameType::Sort));
+        writer.u8(static_cast<uint8_t>(SortAlgorithm::Introsort));
+        writer.u32(1000);
+        for (int i = 0; i < 1000; ++i) {
+            writer.i32(static_cast<int32_t>(rng() % 100000));
+        }
+    } else {
+        writer.begin(FrameHeader(requestId, FrameType::Route));
+        writer.u8(rng() % 2);
+        writer.u8(static_cast<uint8_t>(RouteAlgorithm::Bidirectional));
+        for (int i = 0; i < 2; ++i) {
+            writer.u8(static_cast<uint8_t>(NodeRefKind::Id));
+            writer.u32(pickNode(rng));
+        }
+    }
+    writer.finish();
+}
+
+// One connection: keep `depth` requests outstanding until `count` are answered
+static void runConnection(const std::string& path, size_t count, size_t depth, const std::string& mix,
+                          uint32_t nodes, unsigned seed, LoadResult& result) {
+    int fd = connectTo(path);
+    if (fd < 0) {
+        result.failed = true;
+        return;
+    }
+
+    std::mt19937 rng(seed);
+    std::unordered_map<uint32_t, Clock::time_point> inFlight;
+    result.latencyMicros.reserve(count);
+    uint32_t nextId = 1;
+    size_t sent = 0;
+    FrameWriter writer;
+    FrameHeader header;
+    std::vector<uint8_t> payload;
+
+    while (result.latencyMicros.size() + result.errors < count) {
+        // Top up the pipeline in one write
+        writer.clear();
+        std::vector<std::pair<uint32_t, Clock::time_point>> batch;
+        while (sent < count && inFlight.size() + batch.size() < depth) {
+            writeRequest(writer, nextId, mix, nodes, rng);
+            batch.emplace_back(nextId++, Clock::now());
+            sent++;
+        }
+        for (const auto& entry : batch) {
+            inFlight.insert(entry);
+        }
+        if (!writer.bytes().empty() && !sendAll(fd, writer.bytes())) {
+            result.failed = true;
+            break;
+        }
+
+        if (!receiveFrame(fd, header, payload)) {
+            result.failed = true;
+            break;
+        }
+        auto it = inFlight.find(header.requestId);
+        if (it == inFlight.end()) {
+            result.errors++;
+            continue;
+        }
+        if (header.status == static_cast<uint16_t>(FrameStatus::Ok)) {
+            result.latencyMicros.push_back(
+                std::chrono::duration<double, std::micro>(Clock::now() - it->second).count());
+        } else {
+            result.errors++;
+        }
+        inFlight.erase(it);
+    }
+    close(fd);
+}
+
+static double percentileOf(const std::vector<double>& sorted, double fraction) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t index = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+int main(int argc, char* argv[]) {
+    std::string socketPath = "/tmp/pathfinding.sock";
+    std::string mix = "route";
+    size_t connections = 4, depth = 8, requests = 20000;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (option == "--socket" && hasValue) {
+            socketPath = argv[++i];
+        } else if (option == "--connections" && hasValue) {
+            connections = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+        } else if (option == "--depth" && hasValue) {
+            depth = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+        } else if (option == "--requests" && hasValue) {
+            requests = std::strtoul(argv[++i], nullptr, 10);
+        } else if (option == "--mix" && hasValue) {
+            mix = argv[++i];
+        } else {
+            std::cerr << "Usage: daemon_loadgen [--socket PATH] [--connections N] [--depth N]\n"
+                      << "                      [--requests N] [--mix route|matrix|sort|mixed]" << std::endl;
+            return 1;
+        }
+    }
+    if (mix != "route" && mix != "matrix" && mix != "sort" && mix != "mixed") {
+        std::cerr << "Unknown mix: " << mix << std::endl;
+        return 1;
+    }
+
+    // Ask for the node count so requests only name existing nodes
+    int fd = connectTo(socketPath);
+    if (fd < 0) {
+        return 1;
+    }
+    FrameWriter writer;
+    writer.begin(FrameHeader(0, FrameType::Status));
+    writer.finish();
+    FrameHeader header;
+    std::vector<uint8_t> payload;
+    if (!sendAll(fd, writer.bytes()) || !receiveFrame(fd, header, payload)) {
+        std::cerr << "No status response from daemon" << std::endl;
+        close(fd);
+        return 1;
+    }
+    close(fd);
+    FrameReader status(payload.data(), payload.size());
+    uint32_t nodes = status.u32();
+    uint32_t arcs = status.u32();
+    uint32_t workers = status.u32();
+    if (!status.ok() || nodes == 0) {
+        std::cerr << "Daemon serves an empty graph" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Daemon: " << nodes << " nodes, " << arcs << " arcs, " << workers << " workers" << std::endl;
+    std::cout << "Load: " << requests << " " << mix << " requests over " << connections << " connections, "
+              << depth << " in flight each" << std::endl;
+
+    std::vector<LoadResult> results(connections);
+    std::vector<std::thread> threads;
+    auto start = Clock::now();
+    for (size_t c = 0; c < connections; ++c) {
+        size_t share = requests / connections + (c < requests % connections ? 1 : 0);
+        threads.emplace_back(runConnection, socketPath, share, depth, mix, nodes,
+                             static_cast<unsigned>(1000 + c), std::ref(results[c]));
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::vector<double> latencies;
+    size_t errors = 0;
+    bool failed = false;
+    for (const LoadResult& result : results) {
+        latencies.insert(latencies.end(), result.latencyMicros.begin(), result.latencyMicros.end());
+        errors += result.errors;
+        failed = failed || result.failed;
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Completed: " << latencies.size() << " ok, " << errors << " errors in " << seconds << " s"
+              << (failed ? " (connection lost)" : "") << std::endl;
+    std::cout << "Throughput: " << (seconds > 0 ? latencies.size() / seconds : 0.0) << " requests/s" << std::endl;
+    std::cout << "Latency: p50 " << percentileOf(latencies, 0.5) << " us, p90 " << percentileOf(latencies, 0.9)
+              << " us, p99 " << percentileOf(latencies, 0.99) << " us, max "
+              << (latencies.empty() ? 0.0 : latencies.back()) << " us" << std::endl;
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,192 @@
+#ifndef DAEMON_PROTOCOL_H
+#define DAEMON_PROTOCOL_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * Routing Daemon Wire Protocol
+ * Length-prefixed binary frames over a Unix stream socket, in host byte
+ * order (little-endian on every platform the daemon targets). Each frame is
+ * a 12-byte header followed by `length` payload bytes:
+ *
+ *   uint32 length | uint32 requestId | uint16 type | uint16 status
+ *
+ * Requests send status 0. A response echoes the request's id and type, and
+ * responses can arrive out of order, so clients may pipeline requests on one
+ * connection. Payloads by type:
+ *
+ *   Route   request:  uint8 metric, uint8 RouteAlgorithm, NodeRef from, NodeRef to
+ *           response: f64 distance, f64 time, uint32 settled,
+ *                     uint32 count, count x (uint32 node, string name)
+ *   Matrix  request:  uint8 metric, uint32 rows, uint32 cols (both nonzero), rows + cols NodeRefs
+ *           response: uint32 rows, uint32 cols, rows x cols f64 (row-major, inf if unreachable)
+ *   Sort    request:  uint8 SortAlgorithm, uint32 count, count x int32
+ *           response: uint32 count, count x int32
+ *   Status  request:  empty
+ *           response: uint32 nodes, uint32 arcs, uint32 workers, uint64 requests served
+ *
+ * A NodeRef is a uint8 NodeRefKind followed by a uint32 node id, a string
+ * name, or f64 latitude and f64 longitude (snapped to the nearest node;
+ * finite, within [-90, 90] and [-180, 180], or the request is malformed).
+ * Strings are a uint16 byte count followed by the bytes. Error responses
+ * have an empty payload.
+ */
+
+const size_t FRAME_HEADER_SIZE = 12;
+const uint32_t MAX_FRAME_PAYLOAD = 16u << 20;
+
+enum class FrameType : uint16_t {
+    Route = 1,
+    Matrix = 2,
+    Sort = 3,
+    Status = 4
+};
+
+enum class FrameStatus : uint16_t {
+    Ok = 0,
+    NotFound = 1,    // unknown node or no path
+    BadRequest = 2,  // malformed payload
+    UnknownType = 3,
+    Overloaded = 4   // request queue full, retry later
+};
+
+enum class RouteAlgorithm : uint8_t {
+    Dijkstra = 0,
+    AStar = 1,
+    Bidirectional = 2
+};
+
+enum class SortAlgorithm : uint8_t {
+    Introsort = 0, // std::sort
+    MergeSort = 1, // std::stable_sort
+    HeapSort = 2
+};
+
+enum class NodeRefKind : uint8_t {
+    Id = 0,
+    Name = 1,
+    Coordinates = 2
+};
+
+struct FrameHeader {
+    uint32_t length;
+    uint32_t requestId;
+    uint16_t type;
+    uint16_t status;
+
+    FrameHeader() : length(0), requestId(0), type(0), status(0) {}
+    FrameHeader(uint32_t id, FrameType t, FrameStatus s = FrameStatus::Ok)
+        : length(0), requestId(id), type(static_cast<uint16_t>(t)), status(static_cast<uint16_t>(s)) {}
+};
+
+// Appends one frame at a time; finish() patches the payload length
+class FrameWriter {
+private:
+    std::vector<uint8_t> buffer;
+    size_t frameStart;
+
+    template <typename T>
+    void put(T value) {
+        size_t offset = buffer.size();
+        buffer.resize(offset + sizeof(T));
+        std::memcpy(buffer.data() + offset, &value, sizeof(T));
+    }
+
+public:
+    FrameWriter() : frameStart(0) {}
+
+    void begin(const FrameHeader& header) {
+        frameStart = buffer.size();
+        put<uint32_t>(0);
+        put(header.requestId);
+        put(header.type);
+        put(header.status);
+    }
+    void finish() {
+        uint32_t length = static_cast<uint32_t>(buffer.size() - frameStart - FRAME_HEADER_SIZE);
+        std::memcpy(buffer.data() + frameStart, &length, sizeof(length));
+    }
+
+    void u8(uint8_t value) { put(value); }
+    void u16(uint16_t value) { put(value); }
+    void u32(uint32_t value) { put(value); }
+    void u64(uint64_t value) { put(value); }
+    void i32(int32_t value) { put(value); }
+    void f64(double value) { put(value); }
+    void string(const std::string& text) {
+        uint16_t length = static_cast<uint16_t>(std::min<size_t>(text.size(), UINT16_MAX));
+        put(length);
+        buffer.insert(buffer.end(), text.begin(), text.begin() + length);
+    }
+
+    const std::vector<uint8_t>& bytes() const { return buffer; }
+    std::vector<uint8_t> release() { return std::move(buffer); }
+    void clear() { buffer.clear(); }
+};
+
+// Bounds-checked cursor over a payload; reads past the end return zero and
+// clear ok()
+class FrameReader {
+private:
+    const uint8_t* cursor;
+    const uint8_t* end;
+    bool valid;
+
+    template <typename T>
+    T get() {
+        T value = T();
+        if (static_cast<size_t>(end - cursor) < sizeof(T)) {
+            valid = false;
+            cursor = end;
+            return value;
+        }
+        std::memcpy(&value, cursor, sizeof(T));
+        cursor += sizeof(T);
+        return value;
+    }
+
+public:
+    FrameReader(const uint8_t* data, size_t size) : cursor(data), end(data + size), valid(true) {}
+
+    static FrameHeader header(const uint8_t* data) {
+        FrameReader reader(data, FRAME_HEADER_SIZE);
+        FrameHeader result;
+        result.length = reader.u32();
+        result.requestId = reader.u32();
+        result.type = reader.u16();
+        result.status = reader.u16();
+        return result;
+    }
+
+    uint8_t u8() { return get<uint8_t>(); }
+    uint16_t u16() { return get<uint16_t>(); }
+    uint32_t u32() { return get<uint32_t>(); }
+    uint64_t u64() { return get<uint64_t>(); }
+    int32_t i32() { return get<int32_t>(); }
+    double f64() { return get<double>(); }
+    std::string string() {
+        uint16_t length = u16();
+        if (static_cast<size_t>(end - cursor) < length) {
+            valid = false;
+            cursor = end;
+            return std::string();
+        }
+        std::string text(reinterpret_cast<const char*>(cursor), length);
+        cursor += length;
+        return text;
+    }
+
+    size_t remaining() const { return end - cursor; }
+    bool ok() const { return valid; }
+    // Marks the payload malformed for a value that decodes but is out of range
+    void fail() {
+        valid = false;
+        cursor = end;
+    }
+};
+
+#endif // DAEMON_PROTOCOL_H
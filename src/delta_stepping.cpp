@@ -0,0 +1,240 @@
+#include "delta_stepping.h"
+#include <algorithm>
+
+DeltaSteppingSearch::DeltaSteppingSearch()
+    : capacity(0), currentStamp(0), delta(1.0), settled(0), relaxed(0), phases(0) {}
+
+double DeltaSteppingSearch::autoDelta(const RoadGraph& graph, Metric metric) {
+    size_t edges = graph.edgeCount();
+    if (edges == 0 || graph.nodeCount() == 0) {
+        return 1.0;
+    }
+    double total = 0.0;
+    double heaviest = 0.0;
+    for (EdgeId e = 0; e < edges; ++e) {
+        total += graph.weight(e, metric);
+        heaviest = std::max(heaviest, graph.weight(e, metric));
+    }
+    double averageDegree = static_cast<double>(edges) / graph.nodeCount();
+    double width = total / edges * averageDegree;
+    return width > 0.0 ? width : (heaviest > 0.0 ? heaviest : 1.0);
+}
+
+void DeltaSteppingSearch::prepare(size_t nodeCount, unsigned threads) {
+    if (capacity < nodeCount) {
+        dist.reset(new std::atomic<double>[nodeCount]);
+        capacity = nodeCount;
+    }
+    if (parent.size() != nodeCount) {
+        parent.assign(nodeCount, INVALID_NODE);
+        frontierStamp.assign(nodeCount, 0);
+        settledStamp.assign(nodeCount, 0);
+        currentStamp = 0;
+    }
+    parallelFor(nodeCount, threads, [&](size_t node, unsigned) {
+        dist[node].store(INFINITE_WEIGHT, std::memory_order_relaxed);
+        parent[node] = INVALID_NODE;
+    }, 4096);
+
+    for (auto& bucket : buckets) {
+        bucket.clear();
+    }
+    local.resize(std::max(1u, threads));
+    for (auto& thread : local) {
+        for (size_t index : thread.touched) {
+            thread.lists[index].clear();
+        }
+        thread.touched.clear();
+        thread.relaxed = 0;
+    }
+    settled = 0;
+    relaxed = 0;
+    phases = 0;
+}
+
+uint32_t DeltaSteppingSearch::nextStamp() {
+    if (++currentStamp == 0) {
+        // Stamp wrapped around - invalidate everything explicitly
+        std::fill(frontierStamp.begin(), frontierStamp.end(), 0);
+        std::fill(settledStamp.begin(), settledStamp.end(), 0);
+        currentStamp = 1;
+    }
+    return currentStamp;
+}
+
+void DeltaSteppingSearch::relaxEdges(const RoadGraph& graph, const std::vector<NodeId>& nodes, Metric metric,
+                                     bool light, unsigned threads) {
+    parallelFor(nodes.size(), threads, [&](size_t i, unsigned threadIndex) {
+        ThreadBuckets& mine = local[threadIndex];
+        NodeId node = nodes[i];
+        double base = dist[node].load(std::memory_order_relaxed);
+        for (EdgeId e = graph.firstEdge(node); e < graph.endEdge(node); ++e) {
+            double weight = graph.weight(e, metric);
+            if ((weight <= delta) != light) {
+                continue;
+            }
+            mine.relaxed++;
+            NodeId neighbor = graph.target(e);
+            double newDistance = base + weight;
+            double current = dist[neighbor].load(std::memory_order_relaxed);
+            while (newDistance < current) {
+                if (dist[neighbor].compare_exchange_weak(current, newDistance, std::memory_order_relaxed)) {
+                    size_t index = bucketOf(newDistance);
+                    if (index >= mine.lists.size()) {
+                        mine.lists.resize(index + 1);
+                    }
+                    if (mine.lists[index].empty()) {
+                        mine.touched.push_back(index);
+                    }
+                    mine.lists[index].push_back(neighbor);
+                    break;
+                }
+            }
+        }
+    }, 256);
+}
+
+void DeltaSteppingSearch::mergeBuckets() {
+    for (auto& thread : local) {
+        for (size_t index : thread.touched) {
+            if (index >= buckets.size()) {
+                buckets.resize(index + 1);
+            }
+            auto& list = thread.lists[index];
+            buckets[index].insert(buckets[index].end(), list.begin(), list.end());
+            list.clear();
+        }
+        thread.touched.clear();
+        relaxed += thread.relaxed;
+        thread.relaxed = 0;
+    }
+}
+
+void DeltaSteppingSearch::run(const RoadGraph& graph, NodeId source, NodeId target, Metric metric,
+                              unsigned threads, double bucketWidth) {
+    threads = std::max(1u, threads);
+    prepare(graph.nodeCount(), threads);
+    delta = bucketWidth > 0.0 ? bucketWidth : autoDelta(graph, metric);
+    if (source >= graph.nodeCount()) {
+        return;
+    }
+
+    dist[source].store(0.0, std::memory_order_relaxed);
+    if (buckets.empty()) {
+        buckets.resize(1);
+    }
+    buckets[0].push_back(source);
+
+    std::vector<NodeId> entries, frontier, settledNodes;
+    for (size_t index = 0; index < buckets.size(); ++index) {
+        if (buckets[index].empty()) {
+            continue;
+        }
+
+        // Light phases until the bucket stops refilling
+        uint32_t bucketStamp = nextStamp();
+        settledNodes.clear();
+        while (!buckets[index].empty()) {
+            entries.clear();
+            entries.swap(buckets[index]);
+            uint32_t phaseStamp = nextStamp();
+            frontier.clear();
+            for (NodeId node : entries) {
+                // Skip duplicates and entries left behind by a later improvement
+                if (bucketOf(distanceTo(node)) != index || frontierStamp[node] == phaseStamp) {
+                    continue;
+                }
+                frontierStamp[node] = phaseStamp;
+                frontier.push_back(node);
+                if (settledStamp[node] != bucketStamp) {
+                    settledStamp[node] = bucketStamp;
+                    settledNodes.push_back(node);
+                }
+            }
+            relaxEdges(graph, frontier, metric, true, threads);
+            mergeBuckets();
+            phases++;
+        }
+
+        // Heavy edges always land in later buckets, one pass is enough
+        relaxEdges(graph, settledNodes, metric, false, threads);
+        mergeBuckets();
+        phases++;
+        settled += settledNodes.size();
+
+        // An unreached target has no bucket (bucketOf(inf) is undefined)
+        if (target != INVALID_NODE && target < graph.nodeCount() && distanceTo(target) < INFINITE_WEIGHT &&
+            bucketOf(distanceTo(target)) <= index) {
+            break;
+        }
+    }
+
+    assignParents(graph, source, metric, threads);
+}
+
+void DeltaSteppingSearch::assignParents(const RoadGraph& graph, NodeId source, Metric metric, unsigned threads) {
+    // An in-neighbour attaining the final distance from strictly below is a
+    // valid parent and can never close a cycle
+    parallelFor(graph.nodeCount(), threads, [&](size_t i, unsigned threadIndex) {
+        NodeId node = static_cast<NodeId>(i);
+        double best = distanceTo(node);
+        if (node == source || best == INFINITE_WEIGHT) {
+            return;
+        }
+        for (EdgeId r = graph.firstReverseEdge(node); r < graph.endReverseEdge(node); ++r) {
+            double from = distanceTo(graph.reverseSource(r));
+            if (from < best && from + graph.reverseWeight(r, metric) == best) {
+                parent[node] = graph.reverseSource(r);
+                return;
+            }
+        }
+        local[threadIndex].orphans.push_back(node);
+    }, 4096);
+
+    // The rest sit on zero-weight ties; link them outward from nodes that
+    // already have a parent, so every parent is linked before its children
+    auto linked = [&](NodeId node) { return node == source || parent[node] != INVALID_NODE; };
+    std::vector<NodeId> ready;
+    for (auto& thread : local) {
+        for (NodeId node : thread.orphans) {
+            for (EdgeId r = graph.firstReverseEdge(node); r < graph.endReverseEdge(node); ++r) {
+                NodeId from = graph.reverseSource(r);
+                if (!linked(node) && linked(from) &&
+                    distanceTo(from) + graph.reverseWeight(r, metric) == distanceTo(node)) {
+                    parent[node] = from;
+                    ready.push_back(node);
+                }
+            }
+        }
+        thread.orphans.clear();
+    }
+    while (!ready.empty()) {
+        NodeId from = ready.back();
+        ready.pop_back();
+        for (EdgeId e = graph.firstEdge(from); e < graph.endEdge(from); ++e) {
+            NodeId node = graph.target(e);
+            if (!linked(node) && distanceTo(from) + graph.weight(e, metric) == distanceTo(node)) {
+                parent[node] = from;
+                ready.push_back(node);
+            }
+        }
+    }
+}
+
+SearchStats DeltaSteppingSearch::searchStats() const {
+    SearchStats stats;
+    stats.settled = settled;
+    stats.relaxed = relaxed;
+    return stats;
+}
+
+std::vector<NodeId> DeltaSteppingSearch::pathTo(NodeId node) const {
+    std::vector<NodeId> path;
+    if (node >= parent.size() || distanceTo(node) == INFINITE_WEIGHT) {
+        return path;
+    }
+    for (NodeId current = node; current != INVALID_NODE; current = parent[current]) {
+        path.push_back(current);
+    }
+    return std::vector<NodeId>(path.rbegin(), path.rend());
+}
@@ -0,0 +1,82 @@
+#ifndef DELTA_STEPPING_H
+#define DELTA_STEPPING_H
+
+#include "road_graph.h"
+#include "parallel.h"
+#include "search_stats.h"
+#include <vector>
+#include <atomic>
+#include <memory>
+
+/**
+ * Delta-Stepping Single-Source Search
+ * Nodes are kept in buckets of width delta by tentative distance. The lowest
+ * non-empty bucket is drained in phases: its frontier relaxes light edges
+ * (weight <= delta) in parallel, which may refill the same bucket, until it
+ * stays empty; then every node settled in it relaxes its heavy edges once.
+ * Distances are lowered with a compare-and-swap minimum, and each worker
+ * collects the nodes it improved in its own buckets, merged after the phase.
+ * Final distances equal Dijkstra's bit for bit (both are the minimum of
+ * dist[u] + w over in-neighbours); parents are picked afterwards among
+ * in-neighbours that attain that minimum with a strictly smaller distance.
+ * Nodes reached only over zero-weight edges from equally distant nodes are
+ * linked outward from already linked ones, so parent links never form a cycle.
+ */
+
+class DeltaSteppingSearch {
+private:
+    struct ThreadBuckets {
+        std::vector<std::vector<NodeId>> lists; // by bucket index
+        std::vector<size_t> touched;            // bucket indices with entries
+        std::vector<NodeId> orphans;            // no parent at a strictly smaller distance
+        size_t relaxed;
+    };
+
+    std::unique_ptr<std::atomic<double>[]> dist;
+    size_t capacity;
+    std::vector<NodeId> parent;
+    std::vector<uint32_t> frontierStamp; // queued in the current light phase
+    std::vector<uint32_t> settledStamp;  // settled in the current bucket
+    uint32_t currentStamp;
+    std::vector<std::vector<NodeId>> buckets;
+    std::vector<ThreadBuckets> local;
+    double delta;
+    size_t settled;
+    size_t relaxed;
+    size_t phases;
+
+    void prepare(size_t nodeCount, unsigned threads);
+    uint32_t nextStamp();
+    size_t bucketOf(double distance) const { return static_cast<size_t>(distance / delta); }
+    void relaxEdges(const RoadGraph& graph, const std::vector<NodeId>& nodes, Metric metric, bool light,
+                    unsigned threads);
+    void mergeBuckets();
+    void assignParents(const RoadGraph& graph, NodeId source, Metric metric, unsigned threads);
+
+public:
+    DeltaSteppingSearch();
+
+    // Bucket width from the edge weights: the mean weight, scaled by the
+    // average degree so a light phase does a useful amount of work per thread
+    static double autoDelta(const RoadGraph& graph, Metric metric);
+
+    // Full search from source, or until target's distance is final when
+    // target is given; delta <= 0 picks autoDelta
+    void run(const RoadGraph& graph, NodeId source, NodeId target = INVALID_NODE, Metric metric = Metric::Distance,
+             unsigned threads = defaultThreadCount(), double delta = 0.0);
+
+    double distanceTo(NodeId node) const { return dist[node].load(std::memory_order_relaxed); }
+    NodeId parentOf(NodeId node) const { return parent[node]; }
+
+    // Node sequence source..node, empty when node was not reached
+    std::vector<NodeId> pathTo(NodeId node) const;
+
+    double deltaUsed() const { return delta; }
+    size_t settledCount() const { return settled; }
+    size_t relaxedCount() const { return relaxed; }
+    // Settled and relaxed only: buckets are not a single priority queue
+    SearchStats searchStats() const;
+    size_t phaseCount() const { return phases; }
+};
+
+#endif // DELTA_STEPPING_H
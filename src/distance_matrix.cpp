@@ -0,0 +1,194 @@
+#include "distance_matrix.h"
+#include "priority_queues.h"
+#include <algorithm>
+
+namespace {
+
+// Per-thread search state, reset in O(touched) through stamps
+struct Workspace {
+    std::vector<double> dist;
+    std::vector<double> other;
+    std::vector<uint32_t> stamp;
+    uint32_t currentStamp = 0;
+    IndexedDaryHeap<double, 4> queue;
+
+    void prepare(size_t nodeCount) {
+        if (stamp.size() != nodeCount) {
+            dist.assign(nodeCount, INFINITE_WEIGHT);
+            other.assign(nodeCount, INFINITE_WEIGHT);
+            stamp.assign(nodeCount, 0);
+            currentStamp = 0;
+            queue.reserve(nodeCount);
+        }
+        if (++currentStamp == 0) {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            currentStamp = 1;
+        }
+        queue.clear();
+    }
+
+    bool reached(NodeId node) const { return stamp[node] == currentStamp; }
+};
+
+// Upward search in the hierarchy with stall-on-demand; visit(node, distance)
+// is called for every settled node that was not stalled
+template <typename Visit>
+void upwardSearch(const ContractionHierarchy& ch, NodeId start, bool isForward, Workspace& ws, Visit visit) {
+    ws.prepare(ch.nodeCount());
+    ws.stamp[start] = ws.currentStamp;
+    ws.dist[start] = 0.0;
+    ws.queue.push(start, 0.0);
+
+    while (!ws.queue.empty()) {
+        HeapEntry<double> top = ws.queue.pop();
+        NodeId current = top.node;
+
+        bool stalled = false;
+        EdgeId stallBegin = isForward ? ch.firstDownArc(current) : ch.firstUpArc(current);
+        EdgeId stallEnd = isForward ? ch.endDownArc(current) : ch.endUpArc(current);
+        for (EdgeId a = stallBegin; a < stallEnd && !stalled; ++a) {
+            const ChArc& arc = isForward ? ch.downArc(a) : ch.upArc(a);
+            if (ws.reached(arc.node) && ws.dist[arc.node] + arc.weight < top.key) {
+                stalled = true;
+            }
+        }
+        if (stalled) continue;
+
+        visit(current, top.key);
+
+        EdgeId begin = isForward ? ch.firstUpArc(current) : ch.firstDownArc(current);
+        EdgeId end = isForward ? ch.endUpArc(current) : ch.endDownArc(current);
+        for (EdgeId a = begin; a < end; ++a) {
+            const ChArc& arc = isForward ? ch.upArc(a) : ch.downArc(a);
+            double newDistance = top.key + arc.weight;
+            if (!ws.reached(arc.node) || newDistance < ws.dist[arc.node]) {
+                ws.stamp[arc.node] = ws.currentStamp;
+                ws.dist[arc.node] = newDistance;
+                ws.queue.push(arc.node, newDistance);
+            }
+        }
+    }
+}
+
+struct BucketEntry {
+    NodeId node;
+    uint32_t column;
+    double distance;
+};
+
+} // namespace
+
+DistanceMatrix::DistanceMatrix() : rows(0), cols(0) {}
+
+DistanceMatrix::DistanceMatrix(size_t rows, size_t cols)
+    : rows(rows), cols(cols), values(rows * cols, INFINITE_WEIGHT) {}
+
+DistanceMatrix DistanceMatrix::compute(const RoadGraph& graph, const std::vector<NodeId>& sources,
+                                       const std::vector<NodeId>& targets, Metric metric,
+                                       unsigned threads, DistanceMatrix* alongPath) {
+    DistanceMatrix matrix(sources.size(), targets.size());
+    if (alongPath) *alongPath = DistanceMatrix(sources.size(), targets.size());
+    size_t n = graph.nodeCount();
+    Metric otherMetric = metric == Metric::Distance ? Metric::Time : Metric::Distance;
+
+    // Distinct valid targets; each search stops once all of them are settled
+    std::vector<char> isTarget(n, 0);
+    size_t targetCount = 0;
+    for (NodeId target : targets) {
+        if (target < n && !isTarget[target]) {
+            isTarget[target] = 1;
+            targetCount++;
+        }
+    }
+
+    threads = std::max(1u, threads);
+    std::vector<Workspace> workspaces(threads);
+    parallelFor(sources.size(), threads, [&](size_t i, unsigned thread) {
+        NodeId source = sources[i];
+        if (source >= n || targetCount == 0) return;
+
+        Workspace& ws = workspaces[thread];
+        ws.prepare(n);
+        ws.stamp[source] = ws.currentStamp;
+        ws.dist[source] = 0.0;
+        ws.other[source] = 0.0;
+        ws.queue.push(source, 0.0);
+
+        size_t remaining = targetCount;
+        while (!ws.queue.empty()) {
+            HeapEntry<double> top = ws.queue.pop();
+            NodeId current = top.node;
+            if (isTarget[current] && --remaining == 0) {
+                break;
+            }
+
+            for (EdgeId e = graph.firstEdge(current); e < graph.endEdge(current); ++e) {
+                NodeId neighbor = graph.target(e);
+                double newDistance = top.key + graph.weight(e, metric);
+                if (!ws.reached(neighbor) || newDistance < ws.dist[neighbor]) {
+                    ws.stamp[neighbor] = ws.currentStamp;
+                    ws.dist[neighbor] = newDistance;
+                    ws.other[neighbor] = ws.other[current] + graph.weight(e, otherMetric);
+                    ws.queue.push(neighbor, newDistance);
+                }
+            }
+        }
+
+        for (size_t j = 0; j < targets.size(); ++j) {
+            NodeId target = targets[j];
+            if (target < n && ws.reached(target)) {
+                matrix.at(i, j) = ws.dist[target];
+                if (alongPath) alongPath->at(i, j) = ws.other[target];
+            }
+        }
+    }, 1);
+
+    return matrix;
+}
+
+DistanceMatrix DistanceMatrix::compute(const ContractionHierarchy& ch, const std::vector<NodeId>& sources,
+                                       const std::vector<NodeId>& targets, unsigned threads) {
+    DistanceMatrix matrix(sources.size(), targets.size());
+    size_t n = ch.nodeCount();
+    threads = std::max(1u, threads);
+    std::vector<Workspace> workspaces(threads);
+
+    // Backward upward search from every target, collecting bucket entries per thread
+    std::vector<std::vector<BucketEntry>> entries(threads);
+    parallelFor(targets.size(), threads, [&](size_t j, unsigned thread) {
+        if (targets[j] >= n) return;
+        std::vector<BucketEntry>& local = entries[thread];
+        upwardSearch(ch, targets[j], false, workspaces[thread], [&](NodeId node, double distance) {
+            local.push_back({node, static_cast<uint32_t>(j), distance});
+        });
+    }, 1);
+
+    // Gather the entries into per-node buckets (CSR layout)
+    std::vector<size_t> bucketOffsets(n + 1, 0);
+    for (const auto& local : entries) {
+        for (const BucketEntry& entry : local) bucketOffsets[entry.node + 1]++;
+    }
+    for (size_t node = 0; node < n; ++node) {
+        bucketOffsets[node + 1] += bucketOffsets[node];
+    }
+    std::vector<BucketEntry> buckets(bucketOffsets[n]);
+    std::vector<size_t> fill(bucketOffsets.begin(), bucketOffsets.end() - 1);
+    for (auto& local : entries) {
+        for (const BucketEntry& entry : local) buckets[fill[entry.node]++] = entry;
+        std::vector<BucketEntry>().swap(local);
+    }
+
+    // Forward upward search from every source, scanning the buckets it settles
+    parallelFor(sources.size(), threads, [&](size_t i, unsigned thread) {
+        if (sources[i] >= n) return;
+        double* row = matrix.values.data() + i * matrix.cols;
+        upwardSearch(ch, sources[i], true, workspaces[thread], [&](NodeId node, double distance) {
+            for (size_t b = bucketOffsets[node]; b < bucketOffsets[node + 1]; ++b) {
+                const BucketEntry& entry = buckets[b];
+                row[entry.column] = std::min(row[entry.column], distance + entry.distance);
+            }
+        });
+    }, 1);
+
+    return matrix;
+}
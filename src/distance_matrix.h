@@ -0,0 +1,49 @@
+#ifndef DISTANCE_MATRIX_H
+#define DISTANCE_MATRIX_H
+
+#include "road_graph.h"
+#include "contraction_hierarchy.h"
+#include "parallel.h"
+#include <vector>
+
+/**
+ * Many-to-Many Distance Matrices
+ * Row-major |sources| x |targets| tables of shortest-path costs, with
+ * INFINITE_WEIGHT for unreachable pairs. Without preprocessing, each source
+ * grows one search tree until every target is settled. With a contraction
+ * hierarchy, the bucket algorithm is used: one upward backward search per
+ * target leaves (target, distance) entries in buckets at the nodes it
+ * settles, and one upward forward search per source then only scans those
+ * buckets. Sources (and targets) are processed in parallel.
+ */
+
+class DistanceMatrix {
+private:
+    size_t rows;
+    size_t cols;
+    std::vector<double> values;
+
+public:
+    DistanceMatrix();
+    DistanceMatrix(size_t rows, size_t cols);
+
+    // One search tree per source on the plain graph. When `alongPath` is
+    // given it receives the other metric summed along each chosen path
+    // (e.g. travel time of the shortest-distance route).
+    static DistanceMatrix compute(const RoadGraph& graph, const std::vector<NodeId>& sources,
+                                  const std::vector<NodeId>& targets, Metric metric = Metric::Distance,
+                                  unsigned threads = defaultThreadCount(), DistanceMatrix* alongPath = nullptr);
+
+    // Bucket-based many-to-many in the hierarchy's metric
+    static DistanceMatrix compute(const ContractionHierarchy& ch, const std::vector<NodeId>& sources,
+                                  const std::vector<NodeId>& targets, unsigned threads = defaultThreadCount());
+
+    size_t rowCount() const { return rows; }
+    size_t columnCount() const { return cols; }
+    double at(size_t row, size_t col) const { return values[row * cols + col]; }
+    double& at(size_t row, size_t col) { return values[row * cols + col]; }
+    const double* row(size_t index) const { return values.data() + index * cols; }
+    const std::vector<double>& data() const { return values; }
+};
+
+#endif // DISTANCE_MATRIX_H
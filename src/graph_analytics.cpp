@@ -0,0 +1,114 @@
+#include "graph_analytics.h"
+#include "shortest_path.h"
+#include <algorithm>
+
+namespace {
+
+// Per-thread accumulators, merged after the parallel loop
+struct PartialStats {
+    DijkstraSearch search;
+    size_t reachablePairs = 0;
+    double totalDistance = 0.0;
+    double diameter = -1.0;
+    NodeId diameterSource = INVALID_NODE;
+    NodeId diameterTarget = INVALID_NODE;
+    std::vector<size_t> histogram;
+};
+
+} // namespace
+
+AllPairsStats::AllPairsStats()
+    : metric(Metric::Distance), reachablePairs(0), unreachablePairs(0), totalDistance(0.0),
+      averageDistance(0.0), diameter(0.0), diameterSource(INVALID_NODE), diameterTarget(INVALID_NODE),
+      radius(0.0), center(INVALID_NODE), binWidth(0.0) {}
+
+AllPairsStats AllPairsStats::compute(const RoadGraph& graph, Metric metric, unsigned threads, size_t maxBins) {
+    AllPairsStats stats;
+    stats.metric = metric;
+    size_t n = graph.nodeCount();
+    if (n == 0) {
+        return stats;
+    }
+
+    // Fine bins first, so each thread can bin without knowing the diameter
+    double longestEdge = 0.0;
+    for (EdgeId e = 0; e < graph.edgeCount(); ++e) {
+        longestEdge = std::max(longestEdge, graph.weight(e, metric));
+    }
+    double fineWidth = longestEdge > 0.0 ? longestEdge / 4.0 : 1.0;
+
+    threads = std::max(1u, threads);
+    std::vector<PartialStats> partial(threads);
+    stats.eccentricity.assign(n, 0.0);
+
+    parallelFor(n, threads, [&](size_t index, unsigned thread) {
+        PartialStats& local = partial[thread];
+        NodeId source = static_cast<NodeId>(index);
+        // Keys are monotone without a heuristic, which suits the radix heap
+        local.search.run(graph, source, INVALID_NODE, metric, QueueType::RadixHeap);
+
+        double eccentricity = 0.0;
+        NodeId farthest = INVALID_NODE;
+        for (NodeId node = 0; node < n; ++node) {
+            double d = local.search.distanceTo(node);
+            if (node == source || d == INFINITE_WEIGHT) continue;
+
+            local.reachablePairs++;
+            local.totalDistance += d;
+            if (d > eccentricity || farthest == INVALID_NODE) {
+                eccentricity = d;
+                farthest = node;
+            }
+            size_t bin = static_cast<size_t>(d / fineWidth);
+            if (bin >= local.histogram.size()) local.histogram.resize(bin + 1, 0);
+            local.histogram[bin]++;
+        }
+
+        stats.eccentricity[source] = eccentricity;
+        if (farthest != INVALID_NODE && eccentricity > local.diameter) {
+            local.diameter = eccentricity;
+            local.diameterSource = source;
+            local.diameterTarget = farthest;
+        }
+    }, 16);
+
+    std::vector<size_t> fine;
+    double diameter = -1.0;
+    for (const auto& local : partial) {
+        stats.reachablePairs += local.reachablePairs;
+        stats.totalDistance += local.totalDistance;
+        if (local.diameter > diameter) {
+            diameter = local.diameter;
+            stats.diameterSource = local.diameterSource;
+            stats.diameterTarget = local.diameterTarget;
+        }
+        if (local.histogram.size() > fine.size()) fine.resize(local.histogram.size(), 0);
+        for (size_t i = 0; i < local.histogram.size(); ++i) {
+            fine[i] += local.histogram[i];
+        }
+    }
+
+    stats.unreachablePairs = n * (n - 1) - stats.reachablePairs;
+    stats.averageDistance = stats.reachablePairs > 0 ? stats.totalDistance / stats.reachablePairs : 0.0;
+    stats.diameter = std::max(0.0, diameter);
+
+    for (NodeId node = 0; node < n; ++node) {
+        bool reachesSomething = stats.eccentricity[node] > 0.0;
+        if (reachesSomething && (stats.center == INVALID_NODE || stats.eccentricity[node] < stats.radius)) {
+            stats.radius = stats.eccentricity[node];
+            stats.center = node;
+        }
+    }
+
+    // Coarsen by merging neighbouring bins until the histogram fits
+    size_t factor = 1;
+    while (maxBins > 0 && (fine.size() + factor - 1) / factor > maxBins) {
+        factor *= 2;
+    }
+    stats.binWidth = fineWidth * factor;
+    stats.histogram.assign((fine.size() + factor - 1) / factor, 0);
+    for (size_t i = 0; i < fine.size(); ++i) {
+        stats.histogram[i / factor] += fine[i];
+    }
+    return stats;
+}
@@ -0,0 +1,39 @@
+#ifndef GRAPH_ANALYTICS_H
+#define GRAPH_ANALYTICS_H
+
+#include "road_graph.h"
+#include "parallel.h"
+#include <vector>
+
+/**
+ * All-Pairs Path Statistics
+ * One full single-source search per node (no target, no early exit), with
+ * sources spread over a thread pool. Each thread reuses its own search
+ * workspace and folds distances into private accumulators, which are merged
+ * once at the end.
+ */
+
+struct AllPairsStats {
+    Metric metric;
+    size_t reachablePairs;       // ordered pairs (u, v), u != v, with a path
+    size_t unreachablePairs;
+    double totalDistance;
+    double averageDistance;
+    double diameter;             // largest finite shortest-path distance
+    NodeId diameterSource;
+    NodeId diameterTarget;
+    double radius;               // smallest eccentricity among nodes reaching anything
+    NodeId center;
+    std::vector<double> eccentricity; // max finite distance from each node (0 if isolated)
+    double binWidth;
+    std::vector<size_t> histogram;    // histogram[i] counts distances in [i * binWidth, (i + 1) * binWidth)
+
+    AllPairsStats();
+
+    // maxBins caps the histogram length; bins start at a quarter of the
+    // longest edge and are doubled until they fit
+    static AllPairsStats compute(const RoadGraph& graph, Metric metric = Metric::Distance,
+                                 unsigned threads = defaultThreadCount(), size_t maxBins = 20);
+};
+
+#endif // GRAPH_ANALYTICS_H
@@ -0,0 +1,223 @@
+#include "graph_generators.h"
+#include <random>
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+const double EARTH_RADIUS_KM = 6371.0;
+const double KM_PER_DEGREE = 111.195;
+const double BASE_LAT = 20.0;
+const double BASE_LON = 75.0;
+
+double greatCircleKm(double lat1, double lon1, double lat2, double lon2) {
+    double dLat = (lat2 - lat1) * M_PI / 180.0;
+    double dLon = (lon2 - lon1) * M_PI / 180.0;
+    double a = std::sin(dLat / 2) * std::sin(dLat / 2) +
+               std::cos(lat1 * M_PI / 180.0) * std::cos(lat2 * M_PI / 180.0) *
+               std::sin(dLon / 2) * std::sin(dLon / 2);
+    return 2.0 * EARTH_RADIUS_KM * std::atan2(std::sqrt(a), std::sqrt(1.0 - a));
+}
+
+// Uniform positions in a box of sideKm x sideKm, returned in degrees and in
+// planar km (x east, y north) for neighbour lookups
+void scatterNodes(size_t nodeCount, double sideKm, std::mt19937& gen,
+                  std::vector<double>& latitudes, std::vector<double>& longitudes,
+                  std::vector<double>& xs, std::vector<double>& ys) {
+    std::uniform_real_distribution<> coordinate(0.0, sideKm);
+    double kmPerLonDegree = KM_PER_DEGREE * std::cos(BASE_LAT * M_PI / 180.0);
+    latitudes.resize(nodeCount);
+    longitudes.resize(nodeCount);
+    xs.resize(nodeCount);
+    ys.resize(nodeCount);
+    for (size_t node = 0; node < nodeCount; ++node) {
+        xs[node] = coordinate(gen);
+        ys[node] = coordinate(gen);
+        latitudes[node] = BASE_LAT + ys[node] / KM_PER_DEGREE;
+        longitudes[node] = BASE_LON + xs[node] / kmPerLonDegree;
+    }
+}
+
+} // namespace
+
+RoadGraph generateGridGraph(size_t width, size_t height, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<> lengthNoise(0.8, 1.6);
+    std::uniform_real_distribution<> speed(40.0, 100.0); // km/h
+
+    std::vector<RoadEdge> edges;
+    edges.reserve(width * height * 2);
+    auto id = [width](size_t x, size_t y) { return static_cast<NodeId>(y * width + x); };
+
+    for (size_t y = 0; y < height; ++y) {
+        for (size_t x = 0; x < width; ++x) {
+            if (x + 1 < width) {
+                double length = 1.0 * lengthNoise(gen);
+                edges.emplace_back(id(x, y), id(x + 1, y), length, length / speed(gen));
+            }
+            if (y + 1 < height) {
+                double length = 1.0 * lengthNoise(gen);
+                edges.emplace_back(id(x, y), id(x, y + 1), length, length / speed(gen));
+            }
+        }
+    }
+
+    // Nodes sit 0.75 km apart, so every edge is at least as long as the
+    // great-circle distance between its endpoints
+    const double spacingKm = 0.75;
+    double latStep = spacingKm / KM_PER_DEGREE;
+    double lonStep = spacingKm / (KM_PER_DEGREE * std::cos(BASE_LAT * M_PI / 180.0));
+    std::vector<double> latitudes(width * height), longitudes(width * height);
+    for (size_t y = 0; y < height; ++y) {
+        for (size_t x = 0; x < width; ++x) {
+            latitudes[id(x, y)] = BASE_LAT + y * latStep;
+            longitudes[id(x, y)] = BASE_LON + x * lonStep;
+        }
+    }
+
+    RoadGraph graph = RoadGraph::fromEdges(width * height, edges, true);
+    graph.setNodeInfo({}, std::move(latitudes), std::move(longitudes));
+    return graph;
+}
+
+RoadGraph generateGeometricGraph(size_t nodeCount, unsigned seed, size_t degree) {
+    degree = std::max<size_t>(1, degree);
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<> detour(1.0, 1.3);
+    std::uniform_real_distribution<> speed(40.0, 100.0);
+
+    double sideKm = std::max(1.0, std::sqrt(static_cast<double>(nodeCount)));
+    std::vector<double> latitudes, longitudes, xs, ys;
+    scatterNodes(nodeCount, sideKm, gen, latitudes, longitudes, xs, ys);
+
+    // Bucket nodes into 1 km cells (CSR), then grow rings of cells around
+    // each node until its `degree` nearest neighbours are certain
+    size_t cellsPerSide = static_cast<size_t>(std::ceil(sideKm));
+    auto cellOf = [&](double coordinate) {
+        return std::min(cellsPerSide - 1, static_cast<size_t>(coordinate));
+    };
+    std::vector<size_t> cellStart(cellsPerSide * cellsPerSide + 1, 0);
+    for (size_t node = 0; node < nodeCount; ++node) {
+        cellStart[cellOf(ys[node]) * cellsPerSide + cellOf(xs[node]) + 1]++;
+    }
+    for (size_t cell = 0; cell < cellsPerSide * cellsPerSide; ++cell) {
+        cellStart[cell + 1] += cellStart[cell];
+    }
+    std::vector<NodeId> cellNodes(nodeCount);
+    std::vector<size_t> fill(cellStart.begin(), cellStart.end() - 1);
+    for (size_t node = 0; node < nodeCount; ++node) {
+        cellNodes[fill[cellOf(ys[node]) * cellsPerSide + cellOf(xs[node])]++] = static_cast<NodeId>(node);
+    }
+
+    std::vector<RoadEdge> edges;
+    edges.reserve(nodeCount * degree);
+    std::vector<std::pair<double, NodeId>> candidates;
+    for (size_t node = 0; node < nodeCount; ++node) {
+        long cx = static_cast<long>(cellOf(xs[node]));
+        long cy = static_cast<long>(cellOf(ys[node]));
+        candidates.clear();
+        for (long ring = 0; ring < static_cast<long>(cellsPerSide); ++ring) {
+            for (long y = cy - ring; y <= cy + ring; ++y) {
+                for (long x = cx - ring; x <= cx + ring; ++x) {
+                    bool onRing = std::max(std::labs(x - cx), std::labs(y - cy)) == ring;
+                    if (!onRing || x < 0 || y < 0 || x >= static_cast<long>(cellsPerSide) ||
+                        y >= static_cast<long>(cellsPerSide)) {
+                        continue;
+                    }
+                    size_t cell = static_cast<size_t>(y) * cellsPerSide + static_cast<size_t>(x);
+                    for (size_t i = cellStart[cell]; i < cellStart[cell + 1]; ++i) {
+                        NodeId other = cellNodes[i];
+                        if (other == node) continue;
+                        double dx = xs[other] - xs[node], dy = ys[other] - ys[node];
+                        candidates.emplace_back(dx * dx + dy * dy, other);
+                    }
+                }
+            }
+            // Anything outside this ring is at least `ring` km away
+            if (candidates.size() >= degree) {
+                std::nth_element(candidates.begin(), candidates.begin() + (degree - 1), candidates.end());
+                double kth = std::sqrt(candidates[degree - 1].first);
+                if (kth <= static_cast<double>(ring)) break;
+            }
+        }
+
+        size_t count = std::min(degree, candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end());
+        for (size_t i = 0; i < count; ++i) {
+            NodeId other = candidates[i].second;
+            double length = greatCircleKm(latitudes[node], longitudes[node], latitudes[other], longitudes[other])
+                          * detour(gen);
+            edges.emplace_back(static_cast<NodeId>(node), other, length, length / speed(gen));
+        }
+    }
+
+    RoadGraph graph = RoadGraph::fromEdges(nodeCount, edges, true);
+    graph.setNodeInfo({}, std::move(latitudes), std::move(longitudes));
+    return graph;
+}
+
+RoadGraph generateScaleFreeGraph(size_t nodeCount, unsigned seed, size_t links) {
+    links = std::max<size_t>(1, links);
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<> detour(1.1, 1.5);
+    std::uniform_real_distribution<> speed(60.0, 120.0);
+
+    double sideKm = std::max(1.0, std::sqrt(static_cast<double>(nodeCount)));
+    std::vector<double> latitudes, longitudes, xs, ys;
+    scatterNodes(nodeCount, sideKm, gen, latitudes, longitudes, xs, ys);
+
+    std::vector<RoadEdge> edges;
+    edges.reserve(nodeCount * links);
+    auto link = [&](NodeId a, NodeId b) {
+        double length = greatCircleKm(latitudes[a], longitudes[a], latitudes[b], longitudes[b]) * detour(gen);
+        edges.emplace_back(a, b, length, length / speed(gen));
+    };
+
+    // Seed clique, then preferential attachment through the endpoint list
+    // (a node appears once per incident edge)
+    size_t seedNodes = std::min(nodeCount, links + 1);
+    std::vector<NodeId> endpoints;
+    endpoints.reserve(nodeCount * links * 2);
+    for (NodeId a = 0; a < seedNodes; ++a) {
+        for (NodeId b = a + 1; b < seedNodes; ++b) {
+            link(a, b);
+            endpoints.push_back(a);
+            endpoints.push_back(b);
+        }
+    }
+
+    std::vector<NodeId> chosen;
+    for (size_t node = seedNodes; node < nodeCount; ++node) {
+        std::uniform_int_distribution<size_t> pick(0, endpoints.size() - 1);
+        chosen.clear();
+        while (chosen.size() < links) {
+            NodeId target = endpoints[pick(gen)];
+            if (std::find(chosen.begin(), chosen.end(), target) == chosen.end()) {
+                chosen.push_back(target);
+            }
+        }
+        for (NodeId target : chosen) {
+            link(static_cast<NodeId>(node), target);
+            endpoints.push_back(static_cast<NodeId>(node));
+            endpoints.push_back(target);
+        }
+    }
+
+    RoadGraph graph = RoadGraph::fromEdges(nodeCount, edges, true);
+    graph.setNodeInfo({}, std::move(latitudes), std::move(longitudes));
+    return graph;
+}
+
+RoadGraph generateGraph(const std::string& kind, size_t nodeCount, unsigned seed) {
+    if (kind == "grid") {
+        size_t side = std::max<size_t>(1, static_cast<size_t>(std::sqrt(static_cast<double>(nodeCount))));
+        return generateGridGraph(side, side, seed);
+    }
+    if (kind == "geometric") {
+        return generateGeometricGraph(nodeCount, seed);
+    }
+    if (kind == "scalefree") {
+        return generateScaleFreeGraph(nodeCount, seed);
+    }
+    return RoadGraph();
+}
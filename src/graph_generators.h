@@ -0,0 +1,33 @@
+#ifndef GRAPH_GENERATORS_H
+#define GRAPH_GENERATORS_H
+
+#include "road_graph.h"
+#include <string>
+
+/**
+ * Synthetic Road Network Generators
+ * Undirected test graphs from 10^4 up to 10^7 nodes with coordinates. Every
+ * edge is at least as long as the great-circle distance between its
+ * endpoints, so the geometric A* bounds stay admissible. Times come from a
+ * random speed per edge (40-100 km/h, 60-120 km/h on scale-free graphs).
+ * Node names are left empty; generation is deterministic for a given seed.
+ */
+
+// width x height 4-neighbour grid, nodes 0.75 km apart, edge lengths perturbed by 0.8-1.6 km
+RoadGraph generateGridGraph(size_t width, size_t height, unsigned seed);
+
+// nodeCount points scattered uniformly over a lat/lon box holding about one
+// node per km^2, each linked to its `degree` nearest neighbours with a
+// 0-30% detour on top of the great-circle length
+RoadGraph generateGeometricGraph(size_t nodeCount, unsigned seed, size_t degree = 4);
+
+// Barabasi-Albert preferential attachment: each new node links to `links`
+// existing nodes picked with probability proportional to their degree.
+// Nodes get random positions, and edges are 10-50% longer than the great
+// circle, so hubs end up with long-range links.
+RoadGraph generateScaleFreeGraph(size_t nodeCount, unsigned seed, size_t links = 2);
+
+// "grid", "geometric" or "scalefree" with about nodeCount nodes; empty graph for unknown names
+RoadGraph generateGraph(const std::string& kind, size_t nodeCount, unsigned seed);
+
+#endif // GRAPH_GENERATORS_H
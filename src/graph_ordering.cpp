@@ -0,0 +1,198 @@
+#include "graph_ordering.h"
+#include <algorithm>
+#include <numeric>
+#include <cstdlib>
+
+namespace {
+
+const uint32_t HILBERT_SIDE = 1u << 16;
+
+// Position of cell (x, y) along the Hilbert curve filling a side x side grid
+uint64_t hilbertIndex(uint32_t x, uint32_t y, uint32_t side) {
+    uint64_t index = 0;
+    for (uint32_t s = side / 2; s > 0; s /= 2) {
+        uint32_t rx = (x & s) > 0;
+        uint32_t ry = (y & s) > 0;
+        index += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+        // Rotate the quadrant so the sub-curve starts at its origin
+        if (ry == 0) {
+            if (rx == 1) {
+                x = side - 1 - x;
+                y = side - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return index;
+}
+
+// Outgoing arcs plus, for directed graphs, incoming ones
+template <typename Visit>
+void forEachNeighbor(const RoadGraph& graph, NodeId node, Visit visit) {
+    for (EdgeId e = graph.firstEdge(node); e < graph.endEdge(node); ++e) {
+        visit(graph.target(e));
+    }
+    if (graph.isDirected()) {
+        for (EdgeId r = graph.firstReverseEdge(node); r < graph.endReverseEdge(node); ++r) {
+            visit(graph.reverseSource(r));
+        }
+    }
+}
+
+size_t degree(const RoadGraph& graph, NodeId node) {
+    size_t count = graph.endEdge(node) - graph.firstEdge(node);
+    if (graph.isDirected()) {
+        count += graph.endReverseEdge(node) - graph.firstReverseEdge(node);
+    }
+    return count;
+}
+
+std::vector<NodeId> hilbertOrder(const RoadGraph& graph) {
+    size_t n = graph.nodeCount();
+    double minLat = graph.latitude(0), maxLat = minLat;
+    double minLon = graph.longitude(0), maxLon = minLon;
+    for (NodeId node = 1; node < n; ++node) {
+        minLat = std::min(minLat, graph.latitude(node));
+        maxLat = std::max(maxLat, graph.latitude(node));
+        minLon = std::min(minLon, graph.longitude(node));
+        maxLon = std::max(maxLon, graph.longitude(node));
+    }
+
+    // One scale for both axes keeps the cells square in degrees
+    double span = std::max(std::max(maxLat - minLat, maxLon - minLon), 1e-12);
+    double scale = (HILBERT_SIDE - 1) / span;
+    std::vector<std::pair<uint64_t, NodeId>> keys(n);
+    for (NodeId node = 0; node < n; ++node) {
+        uint32_t x = static_cast<uint32_t>((graph.longitude(node) - minLon) * scale);
+        uint32_t y = static_cast<uint32_t>((graph.latitude(node) - minLat) * scale);
+        keys[node] = {hilbertIndex(x, y, HILBERT_SIDE), node};
+    }
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<NodeId> order(n);
+    for (size_t i = 0; i < n; ++i) {
+        order[i] = keys[i].second;
+    }
+    return order;
+}
+
+std::vector<NodeId> breadthFirstOrder(const RoadGraph& graph) {
+    size_t n = graph.nodeCount();
+    std::vector<NodeId> order;
+    order.reserve(n);
+    std::vector<bool> seen(n, false);
+    for (NodeId root = 0; root < n; ++root) {
+        if (seen[root]) continue;
+        seen[root] = true;
+        order.push_back(root);
+        for (size_t head = order.size() - 1; head < order.size(); ++head) {
+            forEachNeighbor(graph, order[head], [&](NodeId neighbor) {
+                if (!seen[neighbor]) {
+                    seen[neighbor] = true;
+                    order.push_back(neighbor);
+                }
+            });
+        }
+    }
+    return order;
+}
+
+std::vector<NodeId> reverseCuthillMcKeeOrder(const RoadGraph& graph) {
+    size_t n = graph.nodeCount();
+    std::vector<size_t> degrees(n);
+    for (NodeId node = 0; node < n; ++node) {
+        degrees[node] = degree(graph, node);
+    }
+    auto byDegree = [&](NodeId a, NodeId b) {
+        return degrees[a] != degrees[b] ? degrees[a] < degrees[b] : a < b;
+    };
+
+    // Each component starts from its lowest-degree node, a cheap stand-in
+    // for a peripheral one
+    std::vector<NodeId> starts(n);
+    std::iota(starts.begin(), starts.end(), 0);
+    std::sort(starts.begin(), starts.end(), byDegree);
+
+    std::vector<NodeId> order;
+    order.reserve(n);
+    std::vector<bool> seen(n, false);
+    std::vector<NodeId> fresh;
+    for (NodeId root : starts) {
+        if (seen[root]) continue;
+        seen[root] = true;
+        order.push_back(root);
+        for (size_t head = order.size() - 1; head < order.size(); ++head) {
+            fresh.clear();
+            forEachNeighbor(graph, order[head], [&](NodeId neighbor) {
+                if (!seen[neighbor]) {
+                    seen[neighbor] = true;
+                    fresh.push_back(neighbor);
+                }
+            });
+            std::sort(fresh.begin(), fresh.end(), byDegree);
+            order.insert(order.end(), fresh.begin(), fresh.end());
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+} // namespace
+
+std::string nodeOrderingName(NodeOrdering ordering) {
+    switch (ordering) {
+        case NodeOrdering::Original:            return "Original";
+        case NodeOrdering::Hilbert:             return "Hilbert";
+        case NodeOrdering::BreadthFirst:        return "BFS";
+        case NodeOrdering::ReverseCuthillMcKee: return "RCM";
+    }
+    return "Unknown";
+}
+
+NodeOrdering preferredOrdering(const RoadGraph& graph) {
+    return graph.hasCoordinates() ? NodeOrdering::Hilbert : NodeOrdering::ReverseCuthillMcKee;
+}
+
+std::vector<NodeId> computeNodeOrder(const RoadGraph& graph, NodeOrdering ordering) {
+    size_t n = graph.nodeCount();
+    std::vector<NodeId> order;
+    if (n == 0) {
+        return order;
+    }
+
+    switch (ordering) {
+        case NodeOrdering::Original:
+            order.resize(n);
+            std::iota(order.begin(), order.end(), 0);
+            break;
+        case NodeOrdering::Hilbert:
+            order = graph.hasCoordinates() ? hilbertOrder(graph) : reverseCuthillMcKeeOrder(graph);
+            break;
+        case NodeOrdering::BreadthFirst:
+            order = breadthFirstOrder(graph);
+            break;
+        case NodeOrdering::ReverseCuthillMcKee:
+            order = reverseCuthillMcKeeOrder(graph);
+            break;
+    }
+
+    // order lists old ids by new position; callers want the inverse
+    std::vector<NodeId> newIds(n);
+    for (size_t position = 0; position < n; ++position) {
+        newIds[order[position]] = static_cast<NodeId>(position);
+    }
+    return newIds;
+}
+
+double averageArcSpan(const RoadGraph& graph) {
+    if (graph.edgeCount() == 0) {
+        return 0.0;
+    }
+    double total = 0.0;
+    for (NodeId node = 0; node < graph.nodeCount(); ++node) {
+        for (EdgeId e = graph.firstEdge(node); e < graph.endEdge(node); ++e) {
+            total += std::abs(static_cast<double>(graph.target(e)) - node);
+        }
+    }
+    return total / graph.edgeCount();
+}
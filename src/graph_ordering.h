@@ -0,0 +1,38 @@
+#ifndef GRAPH_ORDERING_H
+#define GRAPH_ORDERING_H
+
+#include "road_graph.h"
+#include <vector>
+#include <string>
+
+/**
+ * Locality-Aware Node Ordering
+ * Computes a renumbering that puts nodes which are relaxed together next to
+ * each other in memory, for RoadGraph::renumbered. With coordinates, nodes
+ * are sorted along a Hilbert curve over the bounding box (2^16 cells per
+ * side), which keeps both geographic neighbours and most arcs short. Without
+ * coordinates, breadth-first order or reverse Cuthill-McKee (BFS from a low
+ * degree node, neighbours by ascending degree, then reversed) narrow the
+ * band of the adjacency matrix instead. Arc direction is ignored.
+ */
+
+enum class NodeOrdering {
+    Original,           // identity
+    Hilbert,            // needs coordinates, falls back to RCM
+    BreadthFirst,
+    ReverseCuthillMcKee
+};
+
+std::string nodeOrderingName(NodeOrdering ordering);
+
+// newIds[v] is v's position in the requested order (a permutation)
+std::vector<NodeId> computeNodeOrder(const RoadGraph& graph, NodeOrdering ordering);
+
+// Hilbert when the graph has coordinates, RCM otherwise
+NodeOrdering preferredOrdering(const RoadGraph& graph);
+
+// Mean |u - v| over all arcs u -> v: a cache-independent measure of how far
+// apart in memory the endpoints of a relaxation are
+double averageArcSpan(const RoadGraph& graph);
+
+#endif // GRAPH_ORDERING_H
@@ -0,0 +1,225 @@
+#include "graph_traversal.h"
+#include <algorithm>
+
+BreadthFirstSearch::BreadthFirstSearch()
+    : wordCapacity(0), visitedNodes(0), topDownLevels(0), bottomUpLevels(0) {}
+
+void BreadthFirstSearch::prepare(size_t nodeCount, unsigned threads) {
+    size_t words = (nodeCount + 63) / 64;
+    if (wordCapacity < words) {
+        visited.reset(new std::atomic<uint64_t>[words]);
+        wordCapacity = words;
+    }
+    parallelFor(words, threads, [&](size_t word, unsigned) {
+        visited[word].store(0, std::memory_order_relaxed);
+    }, 4096);
+    parent.assign(nodeCount, INVALID_NODE);
+    depth.resize(nodeCount);
+    frontier.clear();
+    localNext.resize(std::max(1u, threads));
+    visitedNodes = 0;
+    topDownLevels = 0;
+    bottomUpLevels = 0;
+}
+
+// Expands the frontier list into the next one
+void BreadthFirstSearch::topDownStep(const RoadGraph& graph, uint32_t level, unsigned threads) {
+    for (auto& next : localNext) {
+        next.clear();
+    }
+    bool concurrent = threads > 1 && frontier.size() > 64;
+    parallelFor(frontier.size(), threads, [&](size_t i, unsigned threadIndex) {
+        NodeId node = frontier[i];
+        for (EdgeId e = graph.firstEdge(node); e < graph.endEdge(node); ++e) {
+            NodeId neighbor = graph.target(e);
+            if (!isVisited(neighbor) && claim(neighbor, concurrent)) {
+                parent[neighbor] = node;
+                depth[neighbor] = level;
+                localNext[threadIndex].push_back(neighbor);
+            }
+        }
+    }, 64);
+
+    if (localNext.size() == 1) {
+        frontier.swap(localNext[0]);
+    } else {
+        frontier.clear();
+        for (const auto& next : localNext) {
+            frontier.insert(frontier.end(), next.begin(), next.end());
+        }
+    }
+    visitedNodes += frontier.size();
+}
+
+// Every unvisited node scans its incoming arcs for a frontier member. Work
+// is split by bitmap word, so each word of visited/next has a single writer.
+void BreadthFirstSearch::bottomUpStep(const RoadGraph& graph, uint32_t level, unsigned threads) {
+    size_t nodeCount = graph.nodeCount();
+    size_t words = (nodeCount + 63) / 64;
+    std::vector<size_t> found(localNext.size(), 0);
+    parallelFor(words, threads, [&](size_t word, unsigned threadIndex) {
+        uint64_t seen = visited[word].load(std::memory_order_relaxed);
+        uint64_t next = 0;
+        size_t end = std::min(nodeCount, (word + 1) * 64);
+        for (size_t i = word * 64; i < end; ++i) {
+            if (seen & (uint64_t(1) << (i & 63))) {
+                continue;
+            }
+            NodeId node = static_cast<NodeId>(i);
+            for (EdgeId r = graph.firstReverseEdge(node); r < graph.endReverseEdge(node); ++r) {
+                NodeId from = graph.reverseSource(r);
+                if (frontierBits[from >> 6] & (uint64_t(1) << (from & 63))) {
+                    parent[node] = from;
+                    depth[node] = level;
+                    next |= uint64_t(1) << (i & 63);
+                    found[threadIndex]++;
+                    break;
+                }
+            }
+        }
+        nextBits[word] = next;
+        if (next) {
+            visited[word].fetch_or(next, std::memory_order_relaxed);
+        }
+    }, 64);
+
+    frontierBits.swap(nextBits);
+    for (size_t count : found) {
+        visitedNodes += count;
+    }
+}
+
+void BreadthFirstSearch::run(const RoadGraph& graph, NodeId source, NodeId target, unsigned threads) {
+    threads = std::max(1u, threads);
+    size_t nodeCount = graph.nodeCount();
+    prepare(nodeCount, threads);
+    if (source >= nodeCount) {
+        return;
+    }
+
+    claim(source, false);
+    depth[source] = 0;
+    visitedNodes = 1;
+    frontier.push_back(source);
+
+    size_t words = (nodeCount + 63) / 64;
+    double averageDegree = static_cast<double>(graph.edgeCount()) / nodeCount;
+    size_t frontierSize = 1;
+    size_t previousSize = 0;
+    bool bottomUp = false;
+
+    for (uint32_t level = 1; frontierSize > 0; ++level) {
+        if (target != INVALID_NODE && target < nodeCount && isVisited(target)) {
+            break;
+        }
+
+        // Switch only while the frontier grows (or shrinks, going back), so
+        // the tail of a long search stays top-down. Unexplored edges are
+        // estimated from the unvisited node count.
+        if (!bottomUp && frontierSize > previousSize) {
+            size_t frontierEdges = 0;
+            for (NodeId node : frontier) {
+                frontierEdges += graph.endEdge(node) - graph.firstEdge(node);
+            }
+            double unexploredEdges = (nodeCount - visitedNodes) * averageDegree;
+            if (frontierEdges > unexploredEdges / ALPHA) {
+                bottomUp = true;
+                frontierBits.assign(words, 0);
+                nextBits.assign(words, 0);
+                for (NodeId node : frontier) {
+                    frontierBits[node >> 6] |= uint64_t(1) << (node & 63);
+                }
+            }
+        } else if (bottomUp && frontierSize < previousSize && frontierSize < nodeCount / BETA) {
+            bottomUp = false;
+            frontier.clear();
+            for (size_t word = 0; word < words; ++word) {
+                for (uint64_t bits = frontierBits[word]; bits; bits &= bits - 1) {
+                    frontier.push_back(static_cast<NodeId>(word * 64 + __builtin_ctzll(bits)));
+                }
+            }
+        }
+
+        size_t before = visitedNodes;
+        if (bottomUp) {
+            bottomUpStep(graph, level, threads);
+            bottomUpLevels++;
+        } else {
+            topDownStep(graph, level, threads);
+            topDownLevels++;
+        }
+        previousSize = frontierSize;
+        frontierSize = visitedNodes - before;
+    }
+}
+
+std::vector<NodeId> BreadthFirstSearch::pathTo(NodeId node) const {
+    std::vector<NodeId> path;
+    if (!reached(node)) {
+        return path;
+    }
+    for (NodeId current = node; current != INVALID_NODE; current = parent[current]) {
+        path.push_back(current);
+    }
+    return std::vector<NodeId>(path.rbegin(), path.rend());
+}
+
+DepthFirstSearch::DepthFirstSearch() : currentStamp(0) {}
+
+void DepthFirstSearch::run(const RoadGraph& graph, NodeId source, NodeId target) {
+    size_t nodeCount = graph.nodeCount();
+    if (stamp.size() != nodeCount) {
+        parent.assign(nodeCount, INVALID_NODE);
+        stamp.assign(nodeCount, 0);
+        currentStamp = 0;
+    }
+    if (++currentStamp == 0) {
+        // Stamp wrapped around - invalidate everything explicitly
+        std::fill(stamp.begin(), stamp.end(), 0);
+        currentStamp = 1;
+    }
+    order.clear();
+    stack.clear();
+    if (source >= nodeCount) {
+        return;
+    }
+
+    stamp[source] = currentStamp;
+    parent[source] = INVALID_NODE;
+    order.push_back(source);
+    if (source == target) {
+        return;
+    }
+    stack.emplace_back(source, graph.firstEdge(source));
+
+    while (!stack.empty()) {
+        auto& frame = stack.back();
+        if (frame.second == graph.endEdge(frame.first)) {
+            stack.pop_back();
+            continue;
+        }
+        NodeId node = frame.first;
+        NodeId neighbor = graph.target(frame.second++);
+        if (visited(neighbor)) {
+            continue;
+        }
+        stamp[neighbor] = currentStamp;
+        parent[neighbor] = node;
+        order.push_back(neighbor);
+        if (neighbor == target) {
+            break;
+        }
+        stack.emplace_back(neighbor, graph.firstEdge(neighbor));
+    }
+}
+
+std::vector<NodeId> DepthFirstSearch::pathTo(NodeId node) const {
+    std::vector<NodeId> path;
+    if (!reached(node)) {
+        return path;
+    }
+    for (NodeId current = node; current != INVALID_NODE; current = parent[current]) {
+        path.push_back(current);
+    }
+    return std::vector<NodeId>(path.rbegin(), path.rend());
+}
@@ -0,0 +1,108 @@
+#ifndef GRAPH_TRAVERSAL_H
+#define GRAPH_TRAVERSAL_H
+
+#include "road_graph.h"
+#include "parallel.h"
+#include <vector>
+#include <atomic>
+#include <memory>
+
+/**
+ * Unweighted Traversals
+ * Breadth-first search with bitmap visited/frontier sets and Beamer's
+ * direction switching: levels are expanded top-down (frontier pushes to
+ * unvisited neighbours) while the frontier is small, and bottom-up
+ * (unvisited nodes look for any parent in the frontier bitmap, over incoming
+ * arcs) once the frontier's edges outnumber a fraction of the unexplored
+ * ones. Both directions can run over a thread pool.
+ * Depth-first search keeps an explicit stack of (node, next arc) frames, so
+ * it visits nodes in exactly the order the recursive version would without
+ * being limited by the call stack.
+ */
+
+class BreadthFirstSearch {
+private:
+    // Beamer et al.'s thresholds: go bottom-up once frontier edges exceed
+    // unexplored edges / ALPHA, back top-down below nodeCount / BETA frontier nodes
+    static const size_t ALPHA = 15;
+    static const size_t BETA = 18;
+
+    std::vector<NodeId> parent;
+    std::vector<uint32_t> depth;
+    std::unique_ptr<std::atomic<uint64_t>[]> visited;
+    std::vector<uint64_t> frontierBits;
+    std::vector<uint64_t> nextBits;
+    size_t wordCapacity;
+    std::vector<NodeId> frontier;
+    std::vector<std::vector<NodeId>> localNext; // per-thread top-down output
+    size_t visitedNodes;
+    size_t topDownLevels;
+    size_t bottomUpLevels;
+
+    // Marks node visited; true for the caller that set the bit. A single
+    // thread can skip the locked read-modify-write.
+    bool claim(NodeId node, bool concurrent) {
+        uint64_t bit = uint64_t(1) << (node & 63);
+        std::atomic<uint64_t>& word = visited[node >> 6];
+        if (!concurrent) {
+            uint64_t old = word.load(std::memory_order_relaxed);
+            word.store(old | bit, std::memory_order_relaxed);
+            return !(old & bit);
+        }
+        return !(word.fetch_or(bit, std::memory_order_relaxed) & bit);
+    }
+    bool isVisited(NodeId node) const {
+        return visited[node >> 6].load(std::memory_order_relaxed) & (uint64_t(1) << (node & 63));
+    }
+
+    void prepare(size_t nodeCount, unsigned threads);
+    void topDownStep(const RoadGraph& graph, uint32_t level, unsigned threads);
+    void bottomUpStep(const RoadGraph& graph, uint32_t level, unsigned threads);
+
+public:
+    BreadthFirstSearch();
+
+    // Levels from source until everything reachable is visited, or until the
+    // level that reaches `target`
+    void run(const RoadGraph& graph, NodeId source, NodeId target = INVALID_NODE, unsigned threads = 1);
+
+    bool reached(NodeId node) const { return node < parent.size() && isVisited(node); }
+    NodeId parentOf(NodeId node) const { return reached(node) ? parent[node] : INVALID_NODE; }
+    uint32_t depthOf(NodeId node) const { return reached(node) ? depth[node] : UINT32_MAX; }
+
+    // Node sequence source..node with the fewest arcs, empty when node was not reached
+    std::vector<NodeId> pathTo(NodeId node) const;
+
+    size_t visitedCount() const { return visitedNodes; }
+    size_t topDownLevelCount() const { return topDownLevels; }
+    size_t bottomUpLevelCount() const { return bottomUpLevels; }
+};
+
+class DepthFirstSearch {
+private:
+    std::vector<NodeId> parent;
+    std::vector<uint32_t> stamp; // visited when stamp == currentStamp
+    uint32_t currentStamp;
+    std::vector<std::pair<NodeId, EdgeId>> stack; // node and its next arc to try
+    std::vector<NodeId> order;
+
+    bool visited(NodeId node) const { return stamp[node] == currentStamp; }
+
+public:
+    DepthFirstSearch();
+
+    // Preorder walk from source following arcs in adjacency order; stops as
+    // soon as `target` is discovered
+    void run(const RoadGraph& graph, NodeId source, NodeId target = INVALID_NODE);
+
+    bool reached(NodeId node) const { return node < stamp.size() && visited(node); }
+    NodeId parentOf(NodeId node) const { return reached(node) ? parent[node] : INVALID_NODE; }
+
+    // Tree path source..node, empty when node was not reached
+    std::vector<NodeId> pathTo(NodeId node) const;
+
+    const std::vector<NodeId>& visitOrder() const { return order; }
+    size_t visitedCount() const { return order.size(); }
+};
+
+#endif // GRAPH_TRAVERSAL_H
@@ -0,0 +1,300 @@
+#include "landmarks.h"
+#include "priority_queues.h"
+#include "parallel.h"
+#include <algorithm>
+#include <random>
+#include <cmath>
+
+namespace {
+
+// Full single-source Dijkstra, over incoming arcs when `reverse` is set
+void shortestDistances(const RoadGraph& graph, NodeId source, Metric metric, bool reverse,
+                       std::vector<double>& dist, IndexedDaryHeap<double, 4>& queue,
+                       std::vector<NodeId>* parent = nullptr) {
+    dist.assign(graph.nodeCount(), INFINITE_WEIGHT);
+    if (parent) parent->assign(graph.nodeCount(), INVALID_NODE);
+    queue.clear();
+    queue.reserve(graph.nodeCount());
+
+    dist[source] = 0.0;
+    queue.push(source, 0.0);
+    while (!queue.empty()) {
+        HeapEntry<double> top = queue.pop();
+        EdgeId begin = reverse ? graph.firstReverseEdge(top.node) : graph.firstEdge(top.node);
+        EdgeId end = reverse ? graph.endReverseEdge(top.node) : graph.endEdge(top.node);
+        for (EdgeId e = begin; e < end; ++e) {
+            NodeId neighbor = reverse ? graph.reverseSource(e) : graph.target(e);
+            double newDistance = top.key + (reverse ? graph.reverseWeight(e, metric) : graph.weight(e, metric));
+            if (newDistance < dist[neighbor]) {
+                dist[neighbor] = newDistance;
+                if (parent) (*parent)[neighbor] = top.node;
+                queue.push(neighbor, newDistance);
+            }
+        }
+    }
+}
+
+// Node with the largest value, treating infinity (not yet covered) as largest
+NodeId farthestNode(const std::vector<double>& values, const std::vector<char>& isLandmark) {
+    NodeId best = INVALID_NODE;
+    for (NodeId node = 0; node < values.size(); ++node) {
+        if (isLandmark[node]) continue;
+        if (best == INVALID_NODE || values[node] > values[best]) best = node;
+    }
+    return best;
+}
+
+std::vector<NodeId> selectFarthest(const RoadGraph& graph, const LandmarkOptions& options, std::mt19937& gen) {
+    size_t n = graph.nodeCount();
+    std::vector<NodeId> landmarks;
+    std::vector<char> isLandmark(n, 0);
+    std::vector<double> dist;
+    IndexedDaryHeap<double, 4> queue;
+
+    // Start from the node farthest away from a random one
+    NodeId start = std::uniform_int_distribution<NodeId>(0, static_cast<NodeId>(n - 1))(gen);
+    shortestDistances(graph, start, options.metric, false, dist, queue);
+    for (auto& d : dist) if (std::isinf(d)) d = -1.0;
+    NodeId next = farthestNode(dist, isLandmark);
+
+    std::vector<double> minDist(n, INFINITE_WEIGHT);
+    while (landmarks.size() < options.count && next != INVALID_NODE) {
+        landmarks.push_back(next);
+        isLandmark[next] = 1;
+        shortestDistances(graph, next, options.metric, false, dist, queue);
+        for (NodeId node = 0; node < n; ++node) {
+            minDist[node] = std::min(minDist[node], dist[node]);
+        }
+        next = farthestNode(minDist, isLandmark);
+    }
+    return landmarks;
+}
+
+// Goldberg & Werneck's "avoid": grow a shortest-path tree from a random root,
+// weigh each node by how badly the current landmarks bound its distance, and
+// place the next landmark at a leaf of the heaviest subtree with no landmark
+std::vector<NodeId> selectAvoid(const RoadGraph& graph, const LandmarkOptions& options, std::mt19937& gen) {
+    size_t n = graph.nodeCount();
+    LandmarkOptions first = options;
+    first.count = 1;
+    std::vector<NodeId> landmarks = selectFarthest(graph, first, gen);
+    if (landmarks.empty()) return landmarks;
+
+    std::vector<std::vector<float>> landmarkDist; // d(L, v) of the chosen landmarks
+    std::vector<double> dist;
+    std::vector<NodeId> parent;
+    IndexedDaryHeap<double, 4> queue;
+    std::vector<char> isLandmark(n, 0);
+    isLandmark[landmarks[0]] = 1;
+
+    auto remember = [&](NodeId landmark) {
+        shortestDistances(graph, landmark, options.metric, false, dist, queue);
+        landmarkDist.emplace_back(dist.begin(), dist.end());
+    };
+    remember(landmarks[0]);
+
+    std::uniform_int_distribution<NodeId> pickRoot(0, static_cast<NodeId>(n - 1));
+    std::vector<NodeId> order;
+    std::vector<double> size(n);
+    std::vector<char> covered(n);
+    size_t attempts = 0;
+
+    while (landmarks.size() < options.count && attempts++ < options.count * 4) {
+        NodeId root = pickRoot(gen);
+        shortestDistances(graph, root, options.metric, false, dist, queue, &parent);
+
+        order.clear();
+        for (NodeId node = 0; node < n; ++node) {
+            if (!std::isinf(dist[node])) order.push_back(node);
+        }
+        std::sort(order.begin(), order.end(), [&](NodeId a, NodeId b) { return dist[a] > dist[b]; });
+
+        // Subtree sizes, deepest nodes first; subtrees holding a landmark count as zero
+        for (NodeId node : order) {
+            double bound = 0.0;
+            for (const auto& fromL : landmarkDist) {
+                if (!std::isinf(fromL[node]) && !std::isinf(fromL[root])) {
+                    bound = std::max(bound, static_cast<double>(fromL[node]) - fromL[root]);
+                }
+            }
+            size[node] = std::max(0.0, dist[node] - bound);
+            covered[node] = isLandmark[node];
+        }
+        for (NodeId node : order) {
+            if (parent[node] != INVALID_NODE) {
+                size[parent[node]] += size[node];
+                covered[parent[node]] |= covered[node];
+            }
+        }
+
+        NodeId best = INVALID_NODE;
+        for (NodeId node : order) {
+            if (covered[node]) continue;
+            if (best == INVALID_NODE || size[node] > size[best]) best = node;
+        }
+        if (best == INVALID_NODE || size[best] <= 0.0) continue;
+
+        // Walk down to a leaf through the heaviest child
+        NodeId current = best;
+        while (true) {
+            NodeId heaviest = INVALID_NODE;
+            for (EdgeId e = graph.firstEdge(current); e < graph.endEdge(current); ++e) {
+                NodeId child = graph.target(e);
+                if (parent[child] == current && !covered[child] &&
+                    (heaviest == INVALID_NODE || size[child] > size[heaviest])) {
+                    heaviest = child;
+                }
+            }
+            if (heaviest == INVALID_NODE) break;
+            current = heaviest;
+        }
+
+        landmarks.push_back(current);
+        isLandmark[current] = 1;
+        remember(current);
+    }
+
+    // Top up with farthest-first if some roots were already well covered
+    if (landmarks.size() < options.count) {
+        std::vector<double> minDist(n, INFINITE_WEIGHT);
+        for (const auto& fromL : landmarkDist) {
+            for (NodeId node = 0; node < n; ++node) minDist[node] = std::min<double>(minDist[node], fromL[node]);
+        }
+        while (landmarks.size() < options.count) {
+            NodeId next = farthestNode(minDist, isLandmark);
+            if (next == INVALID_NODE) break;
+            landmarks.push_back(next);
+            isLandmark[next] = 1;
+            shortestDistances(graph, next, options.metric, false, dist, queue);
+            for (NodeId node = 0; node < n; ++node) minDist[node] = std::min(minDist[node], dist[node]);
+        }
+    }
+    return landmarks;
+}
+
+// Quantize one landmark's distances into column l of a node-major table,
+// rounding down so stored values never exceed the true distance
+template <typename T>
+double quantizeColumn(const std::vector<double>& dist, std::vector<T>& table, size_t l, size_t k, uint32_t unreachable) {
+    double maxDist = 0.0;
+    for (double d : dist) {
+        if (!std::isinf(d)) maxDist = std::max(maxDist, d);
+    }
+    double unit = maxDist > 0.0 ? maxDist / (unreachable - 1) : 1.0;
+    for (size_t node = 0; node < dist.size(); ++node) {
+        table[node * k + l] = std::isinf(dist[node])
+            ? static_cast<T>(unreachable)
+            : static_cast<T>(std::min<double>(unreachable - 1, std::floor(dist[node] / unit)));
+    }
+    return unit;
+}
+
+} // namespace
+
+LandmarkOptions::LandmarkOptions()
+    : count(16), selection(LandmarkSelection::Avoid), metric(Metric::Distance),
+      threads(defaultThreadCount()), compact(true), activeCount(4), seed(42) {}
+
+LandmarkTable::LandmarkTable()
+    : metric(Metric::Distance), directed(false), compact(true), unreachable(0), activeCount(0) {}
+
+LandmarkTable LandmarkTable::build(const RoadGraph& graph, const LandmarkOptions& options) {
+    LandmarkTable table;
+    table.metric = options.metric;
+    table.directed = graph.isDirected();
+    table.compact = options.compact;
+    table.unreachable = options.compact ? 0xFFFFu : 0xFFFFFFFFu;
+    table.activeCount = options.activeCount;
+    if (graph.nodeCount() == 0 || options.count == 0) {
+        return table;
+    }
+
+    std::mt19937 gen(options.seed);
+    table.landmarks = options.selection == LandmarkSelection::Avoid
+        ? selectAvoid(graph, options, gen)
+        : selectFarthest(graph, options, gen);
+
+    size_t n = graph.nodeCount();
+    size_t k = table.landmarks.size();
+    table.fromUnit.assign(k, 1.0);
+    table.toUnit.assign(k, 1.0);
+    if (table.compact) {
+        table.fromLandmark16.resize(n * k);
+        if (table.directed) table.toLandmark16.resize(n * k);
+    } else {
+        table.fromLandmark32.resize(n * k);
+        if (table.directed) table.toLandmark32.resize(n * k);
+    }
+
+    // One search (two for directed graphs) per landmark, each thread with its own buffers
+    unsigned threads = std::max(1u, options.threads);
+    std::vector<std::vector<double>> dist(threads);
+    std::vector<IndexedDaryHeap<double, 4>> queues(threads);
+    size_t tasks = table.directed ? 2 * k : k;
+    parallelFor(tasks, threads, [&](size_t task, unsigned thread) {
+        size_t l = task % k;
+        bool reverse = task >= k;
+        shortestDistances(graph, table.landmarks[l], table.metric, reverse, dist[thread], queues[thread]);
+        double unit = table.compact
+            ? quantizeColumn(dist[thread], reverse ? table.toLandmark16 : table.fromLandmark16, l, k, table.unreachable)
+            : quantizeColumn(dist[thread], reverse ? table.toLandmark32 : table.fromLandmark32, l, k, table.unreachable);
+        (reverse ? table.toUnit : table.fromUnit)[l] = unit;
+    }, 1);
+
+    return table;
+}
+
+uint32_t LandmarkTable::fromLandmark(NodeId node, size_t l) const {
+    size_t index = node * landmarks.size() + l;
+    return compact ? fromLandmark16[index] : fromLandmark32[index];
+}
+
+uint32_t LandmarkTable::toLandmark(NodeId node, size_t l) const {
+    if (!directed) return fromLandmark(node, l);
+    size_t index = node * landmarks.size() + l;
+    return compact ? toLandmark16[index] : toLandmark32[index];
+}
+
+double LandmarkTable::lowerBound(NodeId from, NodeId to, const std::vector<uint32_t>& active) const {
+    // Each stored value may be up to one unit below the truth, so a difference
+    // of stored values loses at most one unit
+    double best = 0.0;
+    for (uint32_t l : active) {
+        int64_t lFrom = fromLandmark(from, l);
+        int64_t lTo = fromLandmark(to, l);
+        if (lFrom != unreachable && lTo != unreachable) {
+            best = std::max(best, (lTo - lFrom - 1) * fromUnit[l]);
+        }
+        int64_t fromL = toLandmark(from, l);
+        int64_t toL = toLandmark(to, l);
+        if (fromL != unreachable && toL != unreachable) {
+            best = std::max(best, (fromL - toL - 1) * (directed ? toUnit[l] : fromUnit[l]));
+        }
+    }
+    return best;
+}
+
+std::vector<uint32_t> LandmarkTable::selectActive(NodeId source, NodeId target) const {
+    std::vector<std::pair<double, uint32_t>> bounds;
+    for (uint32_t l = 0; l < landmarks.size(); ++l) {
+        bounds.emplace_back(lowerBound(source, target, {l}), l);
+    }
+    size_t count = std::min(activeCount == 0 ? landmarks.size() : activeCount, bounds.size());
+    std::partial_sort(bounds.begin(), bounds.begin() + count, bounds.end(),
+                      [](const std::pair<double, uint32_t>& a, const std::pair<double, uint32_t>& b) {
+                          return a.first > b.first;
+                      });
+
+    std::vector<uint32_t> active;
+    for (size_t i = 0; i < count; ++i) {
+        active.push_back(bounds[i].second);
+    }
+    return active;
+}
+
+size_t LandmarkTable::memoryUsage() const {
+    return (fromLandmark16.capacity() + toLandmark16.capacity()) * sizeof(uint16_t)
+         + (fromLandmark32.capacity() + toLandmark32.capacity()) * sizeof(uint32_t)
+         + (fromUnit.capacity() + toUnit.capacity()) * sizeof(double)
+         + landmarks.capacity() * sizeof(NodeId);
+}
@@ -0,0 +1,70 @@
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include "road_graph.h"
+#include <vector>
+#include <cstdint>
+
+/**
+ * ALT Landmark Tables
+ * Exact distances from (and, for directed graphs, to) a few landmark nodes,
+ * turned into A* lower bounds through the triangle inequality:
+ *   dist(v, t) >= d(L, t) - d(L, v)   and   dist(v, t) >= d(v, L) - d(t, L)
+ * Distances are quantized to 16 or 32 bit integers in node-major order so one
+ * node's landmark values share a cache line. The bounds stay valid when edge
+ * weights only increase, so the table survives traffic slowdowns without a rebuild.
+ */
+
+enum class LandmarkSelection {
+    Farthest, // repeatedly take the node farthest from all chosen landmarks
+    Avoid     // grow landmarks into the shortest-path subtree the bounds cover worst
+};
+
+struct LandmarkOptions {
+    size_t count;
+    LandmarkSelection selection;
+    Metric metric;
+    unsigned threads;
+    bool compact;          // 16-bit storage (coarser) instead of 32-bit
+    size_t activeCount;    // landmarks used per query, picked by their s-t bound
+    unsigned seed;
+
+    LandmarkOptions();
+};
+
+class LandmarkTable {
+private:
+    Metric metric;
+    bool directed;
+    bool compact;
+    uint32_t unreachable;   // sentinel value for infinite distances
+    size_t activeCount;
+    std::vector<NodeId> landmarks;
+    std::vector<double> fromUnit;         // per-landmark quantization step of d(L, v)
+    std::vector<double> toUnit;           // ... and of d(v, L)
+    std::vector<uint16_t> fromLandmark16; // d(L, v) at [v * k + l]
+    std::vector<uint16_t> toLandmark16;   // d(v, L), directed graphs only
+    std::vector<uint32_t> fromLandmark32;
+    std::vector<uint32_t> toLandmark32;
+
+    uint32_t fromLandmark(NodeId node, size_t l) const;
+    uint32_t toLandmark(NodeId node, size_t l) const;
+
+public:
+    LandmarkTable();
+
+    static LandmarkTable build(const RoadGraph& graph, const LandmarkOptions& options = LandmarkOptions());
+
+    bool empty() const { return landmarks.empty(); }
+    Metric getMetric() const { return metric; }
+    const std::vector<NodeId>& getLandmarks() const { return landmarks; }
+
+    // Lower bound on dist(from, to) using the given landmark indices
+    double lowerBound(NodeId from, NodeId to, const std::vector<uint32_t>& active) const;
+    // Landmarks giving the best bound for source -> target, at most activeCount of them
+    std::vector<uint32_t> selectActive(NodeId source, NodeId target) const;
+
+    size_t memoryUsage() const;
+};
+
+#endif // LANDMARKS_H
@@ -0,0 +1,78 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+
+/**
+ * Memory-Mapped Input
+ * Read-only mmap of a whole file plus the zero-copy helpers built on it: a
+ * line/token scanner and number parsing that work directly on the mapped
+ * bytes, and a cursor for reading binary snapshots.
+ */
+
+class MappedFile {
+private:
+    const char* bytes;
+    size_t length;
+    bool opened;
+
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // False (with a message on stderr) when the file cannot be opened or mapped
+    bool open(const std::string& filename);
+    void close();
+
+    bool isOpen() const { return opened; }
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+};
+
+// Parses a whole token as a decimal number; false on any trailing garbage.
+// Short inputs (<= 15 significant digits, |exponent| <= 22) are converted
+// with one exact multiply or divide, which rounds the same as strtod; longer
+// ones fall back to strtod.
+bool parseDouble(std::string_view token, double& value);
+
+// Splits the next line at `cursor` into whitespace-separated tokens (at most
+// maxTokens, extra ones are ignored) and moves cursor past the line ending.
+// Returns the number of tokens stored.
+size_t nextLineTokens(const char*& cursor, const char* end, std::string_view* tokens, size_t maxTokens);
+
+// Sequential reader over a binary snapshot; every read fails once the data runs out
+class MappedReader {
+private:
+    const char* cursor;
+    const char* end;
+
+public:
+    MappedReader(const char* data, size_t size) : cursor(data), end(data + size) {}
+
+    bool readBytes(void* out, size_t count) {
+        if (static_cast<size_t>(end - cursor) < count) return false;
+        if (count > 0) std::memcpy(out, cursor, count);
+        cursor += count;
+        return true;
+    }
+
+    template <typename T>
+    bool read(T& value) { return readBytes(&value, sizeof(T)); }
+
+    // Length-prefixed array, as written by the snapshot writers
+    template <typename T>
+    bool readVector(std::vector<T>& values) {
+        uint64_t count = 0;
+        if (!read(count) || count > static_cast<uint64_t>(end - cursor) / sizeof(T)) return false;
+        values.resize(count);
+        return readBytes(values.data(), count * sizeof(T));
+    }
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,50 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+
+/**
+ * Parallel Loop Helpers
+ * Minimal std::thread based work sharing for the preprocessing and batch engines
+ */
+
+inline unsigned defaultThreadCount() {
+    unsigned count = std::thread::hardware_concurrency();
+    return count == 0 ? 1 : count;
+}
+
+// Runs body(index, threadIndex) for every index in [0, count), handing out
+// chunks of `grain` indices dynamically. threadIndex lets callers keep
+// per-thread scratch space. Runs inline when a single thread is requested.
+template <typename Body>
+void parallelFor(size_t count, unsigned threads, Body body, size_t grain = 64) {
+    threads = std::max(1u, std::min<unsigned>(threads, static_cast<unsigned>((count + grain - 1) / std::max<size_t>(grain, 1))));
+    if (threads <= 1) {
+        for (size_t i = 0; i < count; ++i) body(i, 0u);
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    auto worker = [&](unsigned threadIndex) {
+        while (true) {
+            size_t begin = next.fetch_add(grain);
+            if (begin >= count) break;
+            size_t end = std::min(count, begin + grain);
+            for (size_t i = begin; i < end; ++i) body(i, threadIndex);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) {
+        pool.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto& thread : pool) {
+        thread.join();
+    }
+}
+
+#endif // PARALLEL_H
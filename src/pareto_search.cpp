@@ -0,0 +1,132 @@
+#include "pareto_search.h"
+#include "shortest_path.h"
+#include <algorithm>
+
+ParetoSearch::ParetoSearch() : currentStamp(0), settled(0), relaxed(0), pruned(0), complete(true) {}
+
+void ParetoSearch::prepare(size_t nodeCount) {
+    if (stamp.size() != nodeCount) {
+        bestTime.assign(nodeCount, INFINITE_WEIGHT);
+        boundKm.assign(nodeCount, 0.0);
+        stamp.assign(nodeCount, 0);
+        currentStamp = 0;
+    }
+    if (++currentStamp == 0) {
+        // Stamp wrapped around - invalidate everything explicitly
+        std::fill(stamp.begin(), stamp.end(), 0);
+        currentStamp = 1;
+    }
+    // clear() keeps the capacity, so repeated queries stop allocating
+    arena.clear();
+    queue.clear();
+    frontierLabels.clear();
+    settled = 0;
+    relaxed = 0;
+    pruned = 0;
+    complete = true;
+    queueStats.reset();
+}
+
+void ParetoSearch::touch(NodeId node, NodeId target, const GeoHeuristic* heuristic) {
+    if (stamp[node] != currentStamp) {
+        stamp[node] = currentStamp;
+        bestTime[node] = INFINITE_WEIGHT;
+        boundKm[node] = heuristic ? heuristic->haversine(node, target) : 0.0;
+    }
+}
+
+void ParetoSearch::run(const RoadGraph& graph, NodeId source, NodeId target, const GeoHeuristic* heuristic,
+                       size_t labelLimit) {
+    prepare(graph.nodeCount());
+    if (source >= graph.nodeCount() || target >= graph.nodeCount()) {
+        return;
+    }
+    if (heuristic && heuristic->empty()) {
+        heuristic = nullptr;
+    }
+    // Distance bounds become time bounds at the fastest speed on the graph
+    double hoursPerKm = heuristic && heuristic->fastestSpeed() > 0.0 ? 1.0 / heuristic->fastestSpeed() : 0.0;
+
+    touch(source, target, heuristic);
+    touch(target, target, heuristic);
+    arena.push_back(Label{0.0, 0.0, source, NO_LABEL});
+    queue.push(0, Key(boundKm[source], boundKm[source] * hoursPerKm));
+    queueStats.countPush(queue.size());
+
+    while (!queue.empty()) {
+        uint32_t index = queue.pop().node;
+        queueStats.countPop();
+        Label label = arena[index];
+        double timeBound = boundKm[label.node] * hoursPerKm;
+
+        // The node or the target may have gained a better time since the push
+        if (label.time >= bestTime[label.node] || label.time + timeBound >= bestTime[target]) {
+            pruned++;
+            continue;
+        }
+        bestTime[label.node] = label.time;
+        settled++;
+
+        // Everything popped later is at least as long, so this point is final
+        if (label.node == target) {
+            frontierLabels.push_back(index);
+            continue;
+        }
+        if (labelLimit > 0 && arena.size() >= labelLimit) {
+            complete = false;
+            break;
+        }
+
+        for (EdgeId e = graph.firstEdge(label.node); e < graph.endEdge(label.node); ++e) {
+            relaxed++;
+            NodeId neighbor = graph.target(e);
+            touch(neighbor, target, heuristic);
+            double time = label.time + graph.time(e);
+            double neighborTimeBound = boundKm[neighbor] * hoursPerKm;
+            if (time >= bestTime[neighbor] || time + neighborTimeBound >= bestTime[target]) {
+                pruned++;
+                continue;
+            }
+
+            double distance = label.distance + graph.distance(e);
+            uint32_t child = static_cast<uint32_t>(arena.size());
+            arena.push_back(Label{distance, time, neighbor, index});
+            queue.push(child, Key(distance + boundKm[neighbor], time + neighborTimeBound));
+            queueStats.countPush(queue.size());
+        }
+    }
+}
+
+ParetoPoint ParetoSearch::frontierPoint(size_t index) const {
+    const Label& label = arena[frontierLabels[index]];
+    return ParetoPoint(label.distance, label.time);
+}
+
+std::vector<ParetoPoint> ParetoSearch::frontier() const {
+    std::vector<ParetoPoint> points;
+    points.reserve(frontierLabels.size());
+    for (size_t i = 0; i < frontierLabels.size(); ++i) {
+        points.push_back(frontierPoint(i));
+    }
+    return points;
+}
+
+std::vector<NodeId> ParetoSearch::frontierPath(size_t index) const {
+    std::vector<NodeId> path;
+    if (index >= frontierLabels.size()) {
+        return path;
+    }
+
+    for (uint32_t current = frontierLabels[index]; current != NO_LABEL; current = arena[current].parent) {
+        path.push_back(arena[current].node);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+SearchStats ParetoSearch::searchStats() const {
+    SearchStats stats = queueStats;
+    stats.settled = settled;
+    stats.relaxed = relaxed;
+    return stats;
+}
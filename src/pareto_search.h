@@ -0,0 +1,98 @@
+#ifndef PARETO_SEARCH_H
+#define PARETO_SEARCH_H
+
+#include "road_graph.h"
+#include "priority_queues.h"
+#include "search_stats.h"
+#include <vector>
+
+class GeoHeuristic;
+
+/**
+ * Bi-Criteria Pareto Search
+ * Finds every Pareto-optimal (distance, time) path between two nodes in one
+ * label-setting pass. Labels leave the queue in lexicographic (distance,
+ * time) order, so a label is dominated exactly when its time is no better
+ * than the best time already settled at its node: each node keeps that one
+ * value instead of a label set. Comparing against the target's best time
+ * prunes labels that can no longer join the frontier. Both checks run when a
+ * label is created and again when it is popped, since the bounds tighten
+ * in between. With a GeoHeuristic, great-circle lower bounds on both
+ * criteria are added (bi-objective A*); they are consistent, so the result
+ * is unchanged and far fewer labels are created.
+ * Labels live in one arena that keeps its capacity across runs and record
+ * their parent label, so a path is rebuilt by walking back from the target.
+ */
+
+struct ParetoPoint {
+    double distance;
+    double time;
+
+    ParetoPoint(double d, double t) : distance(d), time(t) {}
+};
+
+class ParetoSearch {
+private:
+    static const uint32_t NO_LABEL = 0xffffffffu;
+
+    struct Label {
+        double distance;
+        double time;
+        NodeId node;
+        uint32_t parent; // arena index, NO_LABEL at the source
+    };
+
+    // Lexicographic queue key: distance bound first, time bound on ties
+    struct Key {
+        double first;
+        double second;
+
+        Key() : first(0.0), second(0.0) {}
+        Key(double f, double s) : first(f), second(s) {}
+        bool operator<(const Key& other) const {
+            return first < other.first || (first == other.first && second < other.second);
+        }
+    };
+
+    std::vector<Label> arena;
+    LazyBinaryHeap<Key> queue;
+    std::vector<double> bestTime; // lowest time settled at each node
+    std::vector<double> boundKm;  // great-circle distance to the target, computed on first touch
+    std::vector<uint32_t> stamp;  // entries are valid only when stamp == currentStamp
+    uint32_t currentStamp;
+    std::vector<uint32_t> frontierLabels; // settled at the target, by increasing distance
+    size_t settled;
+    size_t relaxed;
+    size_t pruned;
+    bool complete;
+    SearchStats queueStats;
+
+    void prepare(size_t nodeCount);
+    void touch(NodeId node, NodeId target, const GeoHeuristic* heuristic);
+
+public:
+    ParetoSearch();
+
+    // Pareto frontier of source -> target. labelLimit > 0 stops the search
+    // once the arena holds that many labels, leaving a partial frontier
+    // (isComplete() false); heuristic may be null or empty
+    void run(const RoadGraph& graph, NodeId source, NodeId target, const GeoHeuristic* heuristic = nullptr,
+             size_t labelLimit = 0);
+
+    // Frontier points by increasing distance (and so decreasing time)
+    size_t frontierSize() const { return frontierLabels.size(); }
+    ParetoPoint frontierPoint(size_t index) const;
+    std::vector<ParetoPoint> frontier() const;
+    // Node sequence source..target of one frontier point
+    std::vector<NodeId> frontierPath(size_t index) const;
+
+    bool isComplete() const { return complete; }
+    size_t labelCount() const { return arena.size(); }
+    size_t settledCount() const { return settled; }
+    size_t relaxedCount() const { return relaxed; }
+    size_t prunedCount() const { return pruned; }
+    // Counters of the last run; queue counters need PATHFINDING_STATS
+    SearchStats searchStats() const;
+};
+
+#endif // PARETO_SEARCH_H
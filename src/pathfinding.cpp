@@ -1,12 +1,14 @@
 #include "pathfinding.h"
+#include "mapped_file.h"
 #include <iostream>
 #include <cmath>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
-#include <stack>
 
-PathfindingVisualizer::PathfindingVisualizer() {
+PathfindingVisualizer::PathfindingVisualizer()
+    : roadGraphDirty(true), cityListsStale(false), adjacencyStale(false), directedRoutes(false), nodeOrdering(NodeOrdering::Original), graphVersion(0),
+      queryCacheEnabled(true), resultCache(4096), treeCache(64), sourceCountsVersion(0) {
     // Initialize with Indian cities
     cities = {
         {"Mumbai", 19.0760, 72.8777},
@@ -74,7 +76,16 @@ PathfindingVisualizer::PathfindingVisualizer() {
     buildGraph();
 }
 
+// The string-keyed map is only needed by the map-based helpers, so bulk
+// loads leave it to the first ensureCityLists call
 void PathfindingVisualizer::buildGraph() {
+    recoverCityLists();
+    adjacencyStale = true;
+    roadGraphDirty = true;
+    graphVersion++;
+}
+
+void PathfindingVisualizer::buildAdjacencyMap() {
     graph.clear();
     
     // Add all cities to graph
@@ -85,158 +96,548 @@ void PathfindingVisualizer::buildGraph() {
     // Add routes to graph
     for (const auto& route : routes) {
         graph[route.from][route.to] = route;
-        // Add reverse route for undirected graph
-        Route reverseRoute(route.to, route.from, route.distance, route.time);
-        graph[route.to][route.from] = reverseRoute;
+        if (!directedRoutes) {
+            // Add reverse route for undirected graph
+            Route reverseRoute(route.to, route.from, route.distance, route.time);
+            graph[route.to][route.from] = reverseRoute;
+        }
+    }
+}
+
+// Brings cities, routes and the route map up to date before they are read
+void PathfindingVisualizer::ensureCityLists() {
+    recoverCityLists();
+    if (adjacencyStale) {
+        adjacencyStale = false;
+        buildAdjacencyMap();
+    }
+}
+
+// Recovers the city and route lists from the snapshot the compact graph was
+// loaded from; an undirected graph stores each route in both directions, so keep one
+void PathfindingVisualizer::recoverCityLists() {
+    if (!cityListsStale) {
+        return;
+    }
+    cityListsStale = false;
+    
+    cities.clear();
+    routes.clear();
+    cities.reserve(roadGraph.nodeCount());
+    for (NodeId node = 0; node < roadGraph.nodeCount(); ++node) {
+        cities.emplace_back(roadGraph.name(node), roadGraph.latitude(node), roadGraph.longitude(node));
+    }
+    for (NodeId node = 0; node < roadGraph.nodeCount(); ++node) {
+        for (EdgeId e = roadGraph.firstEdge(node); e < roadGraph.endEdge(node); ++e) {
+            if (roadGraph.isDirected() || node <= roadGraph.target(e)) {
+                routes.emplace_back(roadGraph.name(node), roadGraph.name(roadGraph.target(e)),
+                                    roadGraph.distance(e), roadGraph.time(e));
+            }
+        }
     }
+    adjacencyStale = true;
 }
 
 void PathfindingVisualizer::addCity(const City& city) {
+    recoverCityLists();
     cities.push_back(city);
-    graph[city.name] = std::map<std::string, Route>();
+    if (!adjacencyStale) {
+        graph[city.name] = std::map<std::string, Route>();
+    }
+    roadGraphDirty = true;
+    graphVersion++;
 }
 
 void PathfindingVisualizer::addRoute(const Route& route) {
-    routes.push_back(route);
-    graph[route.from][route.to] = route;
-    // Add reverse route for undirected graph
-    Route reverseRoute(route.to, route.from, route.distance, route.time);
-    graph[route.to][route.from] = reverseRoute;
+    updateRoutes({route});
 }
 
-PathResult PathfindingVisualizer::dijkstra(const std::string& source, const std::string& destination) {
-    PathResult result;
-    result.algorithm = "Dijkstra";
-    
-    if (!cityExists(source) || !cityExists(destination)) {
-        return result;
+size_t PathfindingVisualizer::updateRoutes(const std::vector<Route>& updates) {
+    recoverCityLists(); // a stale route map is rebuilt from routes when next read
+    for (const auto& update : updates) {
+        // The latest stored route for this road wins on rebuild, so rewrite
+        // that one; append when the road is new
+        bool replaced = false;
+        for (auto it = routes.rbegin(); it != routes.rend(); ++it) {
+            if ((it->from == update.from && it->to == update.to) ||
+                (!directedRoutes && it->from == update.to && it->to == update.from)) {
+                it->distance = update.distance;
+                it->time = update.time;
+                replaced = true;
+                break;
+            }
+        }
+        if (!replaced) {
+            routes.push_back(update);
+        }
+        if (adjacencyStale) {
+            continue;
+        }
+        graph[update.from][update.to] = update;
+        if (!directedRoutes) {
+            // Add reverse route for undirected graph
+            Route reverseRoute(update.to, update.from, update.distance, update.time);
+            graph[update.to][update.from] = reverseRoute;
+        }
     }
     
-    std::map<std::string, double> distances;
-    std::map<std::string, std::string> previous;
-    std::set<std::string> unvisited;
+    uint64_t previousVersion = graphVersion++;
+    if (roadGraphDirty) {
+        return 0; // nothing compiled yet, the next query rebuilds
+    }
     
-    // Initialize distances
-    for (const auto& city : cities) {
-        distances[city.name] = std::numeric_limits<double>::infinity();
-        unvisited.insert(city.name);
+    std::vector<WeightUpdate> weightUpdates;
+    std::vector<ArcChange> changes;
+    bool inserted = false, cheaperDistance = false, cheaperTime = false, faster = false;
+    for (const auto& update : updates) {
+        auto from = cityIndex.find(update.from);
+        auto to = cityIndex.find(update.to);
+        if (from == cityIndex.end() || to == cityIndex.end()) {
+            continue; // skipped by the compact graph, as in rebuildRoadGraph
+        }
+        EdgeId edge = roadGraph.findEdge(from->second, to->second);
+        if (edge == INVALID_EDGE) {
+            inserted = true;
+        } else {
+            cheaperDistance = cheaperDistance || update.distance < roadGraph.distance(edge);
+            cheaperTime = cheaperTime || update.time < roadGraph.time(edge);
+            // Same speed rule as GeoHeuristic::build: a zero-time edge with
+            // positive length is infinitely fast
+            faster = faster || (update.time > 0.0 ? update.distance / update.time > geoHeuristic.fastestSpeed()
+                                                  : update.distance > 0.0);
+            weightUpdates.push_back({from->second, to->second, update.distance, update.time});
+        }
+        changes.emplace_back(from->second, to->second);
+        if (!directedRoutes) {
+            changes.emplace_back(to->second, from->second);
+        }
     }
-    distances[source] = 0.0;
     
-    while (!unvisited.empty()) {
-        std::string current = findMinDistanceCity(distances, unvisited);
-        
-        if (current == destination) {
-            break;
+    if (inserted) {
+        // Cities are unchanged, so node ids survive a rebuild unless the
+        // ordering depends on the arcs
+        bool stableIds = nodeOrdering == NodeOrdering::Original || nodeOrdering == NodeOrdering::Hilbert;
+        if (treeCache.size() == 0 || !stableIds) {
+            roadGraphDirty = true; // nothing to repair, rebuild lazily
+            return 0;
         }
-        
-        unvisited.erase(current);
-        
-        for (const auto& neighbor : graph[current]) {
-            if (unvisited.find(neighbor.first) != unvisited.end()) {
-                double newDistance = distances[current] + neighbor.second.distance;
-                if (newDistance < distances[neighbor.first]) {
-                    distances[neighbor.first] = newDistance;
-                    previous[neighbor.first] = current;
-                }
-            }
+        rebuildRoadGraph();
+    } else {
+        roadGraph.applyWeightUpdates(weightUpdates);
+        hierarchy = ContractionHierarchy(); // shortcuts carry the old weights
+        // Landmark bounds stay valid while costs only grow
+        if (cheaperDistance) {
+            distanceLandmarks = LandmarkTable();
+        }
+        if (cheaperTime) {
+            timeLandmarks = LandmarkTable();
+        }
+        if (faster) {
+            geoHeuristic.build(roadGraph); // time bounds use the fastest edge
         }
     }
     
-    // Reconstruct path
-    result.path = reconstructPath(previous, source, destination);
-    if (!result.path.empty()) {
-    result.totalDistance = calculateTotalDistance(result.path);
-    result.totalTime = calculateTotalTime(result.path);
-    result.routeDetails = getRouteDetails(result.path);
+    size_t settled = 0;
+    treeCache.refresh(previousVersion, graphVersion,
+                      [&](const TreeKey&, std::shared_ptr<const ShortestPathTree>& tree) {
+        // Copy on write: callers may still hold the previous tree. The shard
+        // lock is held, so a sole reference cannot be shared mid-repair, and
+        // cached trees are all created non-const by hotSourceTree.
+        if (tree.use_count() == 1) {
+            settled += std::const_pointer_cast<ShortestPathTree>(tree)->repair(roadGraph, changes);
+            return true;
+        }
+        auto repaired = std::make_shared<ShortestPathTree>(*tree);
+        settled += repaired->repair(roadGraph, changes);
+        tree = repaired;
+        return true;
+    });
+    if (sourceCountsVersion == previousVersion) {
+        sourceCountsVersion = graphVersion; // the same origins are still hot
+    }
+    return settled;
 }
-    
-    return result;
+
+void PathfindingVisualizer::setDirectedRoutes(bool directed) {
+    if (directedRoutes != directed) {
+        directedRoutes = directed;
+        buildGraph();
+    }
 }
 
-PathResult PathfindingVisualizer::breadthFirstSearch(const std::string& source, const std::string& destination) {
+void PathfindingVisualizer::setNodeOrdering(NodeOrdering ordering) {
+    if (nodeOrdering != ordering) {
+        nodeOrdering = ordering;
+        roadGraphDirty = true;
+        graphVersion++; // node ids change
+    }
+}
+
+template <typename Compute>
+PathResult PathfindingVisualizer::cachedQuery(const std::string& source, const std::string& destination,
+                                             Metric metric, const std::string& algorithm, uint32_t variant,
+                                             Compute compute) {
+    queryStats.reset();
+    QueryKey key{source, destination, metric, algorithm, variant};
     PathResult result;
-    result.algorithm = "BFS";
-    
-    if (!cityExists(source) || !cityExists(destination)) {
-        return result;
+    bool cacheHit = false;
+    if (queryCacheEnabled) {
+        PhaseTimer timer(queryStats, SearchPhase::Lookup);
+        cacheHit = resultCache.get(key, graphVersion, result);
+    }
+    if (!cacheHit) {
+        {
+            PhaseTimer timer(queryStats, SearchPhase::Search);
+            result = compute();
+        }
+        if (queryCacheEnabled) {
+            resultCache.put(key, graphVersion, result);
+        }
     }
     
-    std::map<std::string, std::string> previous;
-    std::map<std::string, bool> visited;
-    std::queue<std::string> queue;
-    
-    // Initialize visited map
-    for (const auto& city : cities) {
-        visited[city.name] = false;
+    // Counters come from the search that ran (none on a hit), times from this call
+    if (cacheHit) {
+        result.stats.reset();
+    }
+    result.stats.cacheHit = cacheHit;
+    for (size_t p = 0; p < SEARCH_PHASE_COUNT; ++p) {
+        result.stats.phaseMicros[p] = queryStats.phaseMicros[p];
+    }
+    if constexpr (SEARCH_STATS_ENABLED) {
+        // makePathResult runs inside the search timer
+        result.stats.phaseMicros[static_cast<size_t>(SearchPhase::Search)] -=
+            queryStats.phaseMicros[static_cast<size_t>(SearchPhase::Unpack)];
+        queryStatsCollector.record(algorithm, result.stats);
+    }
+    return result;
+}
+
+std::shared_ptr<const ShortestPathTree> PathfindingVisualizer::hotSourceTree(NodeId source, Metric metric) {
+    std::shared_ptr<const ShortestPathTree> tree;
+    if (!queryCacheEnabled) {
+        return tree;
+    }
+    if (treeCache.get({source, metric}, graphVersion, tree)) {
+        return tree;
     }
     
-    queue.push(source);
-    visited[source] = true;
+    if (sourceCountsVersion != graphVersion) {
+        sourceQueryCounts.clear();
+        sourceCountsVersion = graphVersion;
+    }
+    if (++sourceQueryCounts[source] < HOT_SOURCE_QUERIES) {
+        return tree;
+    }
     
-    while (!queue.empty()) {
-        std::string current = queue.front();
-        queue.pop();
+    // Hot origin: grow its full tree once, later queries from here are lookups
+    auto built = std::make_shared<ShortestPathTree>(ShortestPathTree::build(roadGraph, source, metric));
+    treeCache.put({source, metric}, graphVersion, built);
+    return built;
+}
+
+void PathfindingVisualizer::setQueryCacheEnabled(bool enabled) {
+    queryCacheEnabled = enabled;
+    if (!enabled) {
+        clearQueryCache();
+    }
+}
+
+void PathfindingVisualizer::clearQueryCache() {
+    resultCache.clear();
+    treeCache.clear();
+    sourceQueryCounts.clear();
+}
+
+QueryCacheStats PathfindingVisualizer::getQueryCacheStats() {
+    QueryCacheStats stats;
+    stats.resultHits = resultCache.hitCount();
+    stats.resultMisses = resultCache.missCount();
+    stats.resultEntries = resultCache.size();
+    stats.treeHits = treeCache.hitCount();
+    stats.treeMisses = treeCache.missCount();
+    stats.treeEntries = treeCache.size();
+    return stats;
+}
+
+PathResult PathfindingVisualizer::dijkstra(const std::string& source, const std::string& destination,
+                                          QueueType queue) {
+    return cachedQuery(source, destination, Metric::Distance, "Dijkstra", static_cast<uint32_t>(queue), [&]() {
+        NodeId sourceId = getCityId(source);
+        NodeId destinationId = getCityId(destination);
         
-        if (current == destination) {
-            break;
+        if (sourceId == INVALID_NODE || destinationId == INVALID_NODE) {
+            PathResult result;
+            result.algorithm = "Dijkstra";
+            return result;
         }
         
-        for (const auto& neighbor : graph[current]) {
-            if (!visited[neighbor.first]) {
-                visited[neighbor.first] = true;
-                previous[neighbor.first] = current;
-                queue.push(neighbor.first);
-            }
+        if (auto tree = hotSourceTree(sourceId, Metric::Distance)) {
+            return makePathResult(tree->pathTo(destinationId), "Dijkstra");
+        }
+        
+        dijkstraSearch.run(roadGraph, sourceId, destinationId, Metric::Distance, queue);
+        PathResult result = makePathResult(dijkstraSearch.pathTo(destinationId), "Dijkstra");
+        recordWork(result, dijkstraSearch.searchStats());
+        return result;
+    });
+}
+
+PathResult PathfindingVisualizer::aStar(const std::string& source, const std::string& destination,
+                                       HeuristicMode mode) {
+    return cachedQuery(source, destination, Metric::Distance, "A*", static_cast<uint32_t>(mode), [&]() {
+        NodeId sourceId = getCityId(source);
+        NodeId destinationId = getCityId(destination);
+        
+        if (sourceId == INVALID_NODE || destinationId == INVALID_NODE) {
+            PathResult result;
+            result.algorithm = "A*";
+            return result;
+        }
+        
+        dijkstraSearch.runAStar(roadGraph, sourceId, destinationId, Metric::Distance, geoHeuristic, mode);
+        PathResult result = makePathResult(dijkstraSearch.pathTo(destinationId), "A*");
+        recordWork(result, dijkstraSearch.searchStats());
+        return result;
+    });
+}
+
+PathResult PathfindingVisualizer::bidirectionalDijkstra(const std::string& source, const std::string& destination) {
+    return cachedQuery(source, destination, Metric::Distance, "Bidirectional Dijkstra", 0, [&]() {
+        NodeId sourceId = getCityId(source);
+        NodeId destinationId = getCityId(destination);
+        
+        if (sourceId == INVALID_NODE || destinationId == INVALID_NODE) {
+            PathResult result;
+            result.algorithm = "Bidirectional Dijkstra";
+            return result;
+        }
+        
+        bidirectionalSearch.run(roadGraph, sourceId, destinationId, Metric::Distance);
+        PathResult result = makePathResult(bidirectionalSearch.path(), "Bidirectional Dijkstra");
+        recordWork(result, bidirectionalSearch.searchStats());
+        return result;
+    });
+}
+
+PathResult PathfindingVisualizer::deltaStepping(const std::string& source, const std::string& destination,
+                                                unsigned threads) {
+    return cachedQuery(source, destination, Metric::Distance, "Delta-Stepping", threads, [&]() {
+        NodeId sourceId = getCityId(source);
+        NodeId destinationId = getCityId(destination);
+        
+        if (sourceId == INVALID_NODE || destinationId == INVALID_NODE) {
+            PathResult result;
+            result.algorithm = "Delta-Stepping";
+            return result;
         }
+        
+        deltaSteppingSearch.run(roadGraph, sourceId, destinationId, Metric::Distance, threads);
+        PathResult result = makePathResult(deltaSteppingSearch.pathTo(destinationId), "Delta-Stepping");
+        recordWork(result, deltaSteppingSearch.searchStats());
+        return result;
+    });
+}
+
+PathResult PathfindingVisualizer::bidirectionalAStar(const std::string& source, const std::string& destination) {
+    return cachedQuery(source, destination, Metric::Distance, "Bidirectional A*", 0, [&]() {
+        NodeId sourceId = getCityId(source);
+        NodeId destinationId = getCityId(destination);
+        
+        if (sourceId == INVALID_NODE || destinationId == INVALID_NODE) {
+            PathResult result;
+            result.algorithm = "Bidirectional A*";
+            return result;
+        }
+        
+        bidirectionalSearch.runAStar(roadGraph, sourceId, destinationId, Metric::Distance, geoHeuristic);
+        PathResult result = makePathResult(bidirectionalSearch.path(), "Bidirectional A*");
+        recordWork(result, bidirectionalSearch.searchStats());
+        return result;
+    });
+}
+
+PathResult PathfindingVisualizer::altSearch(const std::string& source, const std::string& destination,
+                                           Metric metric) {
+    // Nothing is cached until the tables exist, so building them needs no invalidation
+    getRoadGraph();
+    if ((metric == Metric::Distance ? distanceLandmarks : timeLandmarks).empty()) {
+        PathResult result;
+        result.algorithm = "ALT";
+        return result;
     }
     
-    // Reconstruct path
-    result.path = reconstructPath(previous, source, destination);
-    if (!result.path.empty()) {
-        result.totalDistance = calculateTotalDistance(result.path);
-        result.totalTime = calculateTotalTime(result.path);
-        result.routeDetails = getRouteDetails(result.path);
+    return cachedQuery(source, destination, metric, "ALT", 0, [&]() {
+        NodeId sourceId = getCityId(source);
+        NodeId destinationId = getCityId(destination);
+        const LandmarkTable& landmarks = metric == Metric::Distance ? distanceLandmarks : timeLandmarks;
+        
+        if (sourceId == INVALID_NODE || destinationId == INVALID_NODE) {
+            PathResult result;
+            result.algorithm = "ALT";
+            return result;
+        }
+        
+        dijkstraSearch.runALT(roadGraph, sourceId, destinationId, landmarks);
+        PathResult result = makePathResult(dijkstraSearch.pathTo(destinationId), "ALT");
+        recordWork(result, dijkstraSearch.searchStats());
+        return result;
+    });
+}
+
+PathResult PathfindingVisualizer::contractionHierarchyQuery(const std::string& source, const std::string& destination) {
+    getRoadGraph();
+    if (hierarchy.empty()) {
+        PathResult result;
+        result.algorithm = "Contraction Hierarchies";
+        return result;
     }
     
-    return result;
+    return cachedQuery(source, destination, hierarchy.getMetric(), "Contraction Hierarchies", 0, [&]() {
+        NodeId sourceId = getCityId(source);
+        NodeId destinationId = getCityId(destination);
+        
+        if (sourceId == INVALID_NODE || destinationId == INVALID_NODE) {
+            PathResult result;
+            result.algorithm = "Contraction Hierarchies";
+            return result;
+        }
+        
+        hierarchyQuery.run(hierarchy, sourceId, destinationId);
+        PathResult result = makePathResult(hierarchyQuery.path(hierarchy), "Contraction Hierarchies");
+        recordWork(result, hierarchyQuery.searchStats());
+        return result;
+    });
+}
+
+PathResult PathfindingVisualizer::breadthFirstSearch(const std::string& source, const std::string& destination) {
+    return cachedQuery(source, destination, Metric::Distance, "BFS", 0, [&]() {
+        NodeId sourceId = getCityId(source);
+        NodeId destinationId = getCityId(destination);
+        
+        if (sourceId == INVALID_NODE || destinationId == INVALID_NODE) {
+            PathResult result;
+            result.algorithm = "BFS";
+            return result;
+        }
+        
+        breadthFirstSearchEngine.run(roadGraph, sourceId, destinationId);
+        PathResult result = makePathResult(breadthFirstSearchEngine.pathTo(destinationId), "BFS");
+        SearchStats work;
+        work.settled = breadthFirstSearchEngine.visitedCount();
+        recordWork(result, work);
+        return result;
+    });
 }
 
 PathResult PathfindingVisualizer::depthFirstSearch(const std::string& source, const std::string& destination) {
-    PathResult result;
-    result.algorithm = "DFS";
-    
-    if (!cityExists(source) || !cityExists(destination)) {
+    return cachedQuery(source, destination, Metric::Distance, "DFS", 0, [&]() {
+        PathResult result;
+        result.algorithm = "DFS";
+        
+        if (!cityExists(source) || !cityExists(destination)) {
+            return result;
+        }
+        
+        std::map<std::string, bool> visited;
+        std::map<std::string, std::string> previous;
+        bool found = false;
+        
+        // Initialize visited map
+        for (const auto& city : cities) {
+            visited[city.name] = false;
+        }
+        
+        // Explicit stack of (city, next neighbour) frames, visiting neighbours
+        // in the same order as a recursive walk without its depth limit
+        using NeighborIterator = std::map<std::string, Route>::const_iterator;
+        std::vector<std::pair<std::string, NeighborIterator>> stack;
+        visited[source] = true;
+        found = source == destination;
+        if (!found) {
+            stack.emplace_back(source, graph[source].cbegin());
+        }
+        
+        while (!stack.empty() && !found) {
+            auto& frame = stack.back();
+            if (frame.second == graph[frame.first].cend()) {
+                stack.pop_back();
+                continue;
+            }
+            std::string current = frame.first;
+            const std::string& neighbor = (frame.second++)->first;
+            if (visited[neighbor]) {
+                continue;
+            }
+            visited[neighbor] = true;
+            previous[neighbor] = current;
+            if (neighbor == destination) {
+                found = true;
+            } else {
+                stack.emplace_back(neighbor, graph[neighbor].cbegin());
+            }
+        }
+        
+        // Reconstruct path if found
+        if (found) {
+            result.path = reconstructPath(previous, source, destination);
+            result.totalDistance = calculateTotalDistance(result.path);
+            result.totalTime = calculateTotalTime(result.path);
+            result.routeDetails = getRouteDetails(result.path);
+        }
+        
+        return result;
+    });
+}
+
+PathResult PathfindingVisualizer::routeBetweenCoordinates(double fromLatitude, double fromLongitude,
+                                                          double toLatitude, double toLongitude) {
+    std::string source = nearestCity(fromLatitude, fromLongitude);
+    std::string destination = nearestCity(toLatitude, toLongitude);
+    if (source.empty() || destination.empty()) {
+        PathResult result;
+        result.algorithm = "Dijkstra";
         return result;
     }
-    
-    std::map<std::string, bool> visited;
-    std::map<std::string, std::string> previous;
-    bool found = false;
-    
-    // Initialize visited map
-    for (const auto& city : cities) {
-        visited[city.name] = false;
+    return dijkstra(source, destination);
+}
+
+std::vector<PathResult> PathfindingVisualizer::paretoRoutes(const std::string& source,
+                                                        const std::string& destination) {
+    std::vector<PathResult> results;
+    NodeId sourceId = getCityId(source);
+    NodeId destinationId = getCityId(destination);
+    if (sourceId == INVALID_NODE || destinationId == INVALID_NODE) {
+        return results;
     }
     
-    // Start DFS from source
-    dfsHelper(source, destination, visited, previous, found);
-    
-    // Reconstruct path if found
-    if (found) {
-        result.path = reconstructPath(previous, source, destination);
-        result.totalDistance = calculateTotalDistance(result.path);
-        result.totalTime = calculateTotalTime(result.path);
-        result.routeDetails = getRouteDetails(result.path);
+    // One search yields the whole frontier, so this bypasses the single-route cache
+    queryStats.reset();
+    {
+        PhaseTimer timer(queryStats, SearchPhase::Search);
+        paretoSearch.run(roadGraph, sourceId, destinationId, &geoHeuristic);
+    }
+    for (size_t i = 0; i < paretoSearch.frontierSize(); ++i) {
+        results.push_back(makePathResult(paretoSearch.frontierPath(i), "Pareto"));
     }
     
-    return result;
+    SearchStats work = paretoSearch.searchStats();
+    for (size_t p = 0; p < SEARCH_PHASE_COUNT; ++p) {
+        work.phaseMicros[p] = queryStats.phaseMicros[p];
+    }
+    for (PathResult& result : results) {
+        recordWork(result, work);
+    }
+    if constexpr (SEARCH_STATS_ENABLED) {
+        queryStatsCollector.record("Pareto", work);
+    }
+    return results;
 }
 
 std::vector<PathResult> PathfindingVisualizer::compareAlgorithms(const std::string& source, const std::string& destination) {
     std::vector<PathResult> results;
     
     results.push_back(dijkstra(source, destination));
+    results.push_back(aStar(source, destination));
     results.push_back(breadthFirstSearch(source, destination));
     results.push_back(depthFirstSearch(source, destination));
     
@@ -244,24 +645,18 @@ std::vector<PathResult> PathfindingVisualizer::compareAlgorithms(const std::stri
 }
 
 double PathfindingVisualizer::calculateHeuristic(const std::string& city1, const std::string& city2) {
-    // Find city coordinates
-    double lat1 = 0, lon1 = 0, lat2 = 0, lon2 = 0;
+    NodeId from = getCityId(city1);
+    NodeId to = getCityId(city2);
     
-    for (const auto& city : cities) {
-        if (city.name == city1) {
-            lat1 = city.latitude;
-            lon1 = city.longitude;
-        }
-        if (city.name == city2) {
-            lat2 = city.latitude;
-            lon2 = city.longitude;
-        }
+    if (from == INVALID_NODE || to == INVALID_NODE) {
+        return 0.0;
     }
     
-    return haversineDistance(lat1, lon1, lat2, lon2);
+    return geoHeuristic.haversine(from, to);
 }
 
 std::vector<std::string> PathfindingVisualizer::getNeighbors(const std::string& city) {
+    ensureCityLists();
     std::vector<std::string> neighbors;
     
     if (graph.find(city) != graph.end()) {
@@ -273,7 +668,31 @@ std::vector<std::string> PathfindingVisualizer::getNeighbors(const std::string&
     return neighbors;
 }
 
+const RoadGraph& PathfindingVisualizer::getRoadGraph() {
+    if (roadGraphDirty) {
+        rebuildRoadGraph();
+    }
+    return roadGraph;
+}
+
+NodeId PathfindingVisualizer::getCityId(const std::string& cityName) {
+    getRoadGraph();
+    auto it = cityIndex.find(cityName);
+    return it != cityIndex.end() ? it->second : INVALID_NODE;
+}
+
+std::string PathfindingVisualizer::nearestCity(double latitude, double longitude) {
+    SpatialMatch match = getSpatialIndex().nearest(latitude, longitude);
+    return match.node != INVALID_NODE ? roadGraph.name(match.node) : std::string();
+}
+
+const SpatialIndex& PathfindingVisualizer::getSpatialIndex() {
+    getRoadGraph();
+    return spatialIndex;
+}
+
 bool PathfindingVisualizer::cityExists(const std::string& cityName) {
+    ensureCityLists();
     for (const auto& city : cities) {
         if (city.name == cityName) {
             return true;
@@ -299,6 +718,21 @@ void PathfindingVisualizer::printPath(const PathResult& result) {
     std::cout << std::endl;
     std::cout << "Total Distance: " << result.totalDistance << " km" << std::endl;
     std::cout << "Total Time: " << result.totalTime << " hours" << std::endl;
+    if (result.nodesExpanded > 0) {
+        std::cout << "Nodes Expanded: " << result.nodesExpanded << std::endl;
+    }
+    if constexpr (SEARCH_STATS_ENABLED) {
+        const SearchStats& stats = result.stats;
+        std::cout << "Search Stats: " << stats.settled << " settled, " << stats.relaxed << " relaxed, "
+                  << stats.pushes << " pushes, " << stats.pops << " pops, peak queue " << stats.peakQueueSize
+                  << (stats.cacheHit ? ", cache hit" : "") << std::endl;
+        std::cout << "Phase Times: ";
+        for (size_t p = 0; p < SEARCH_PHASE_COUNT; ++p) {
+            std::cout << (p > 0 ? ", " : "") << searchPhaseName(static_cast<SearchPhase>(p)) << " "
+                      << stats.phaseMicros[p] << " μs";
+        }
+        std::cout << std::endl;
+    }
     std::cout << "Route Details:" << std::endl;
     
     for (const auto& route : result.routeDetails) {
@@ -307,6 +741,61 @@ void PathfindingVisualizer::printPath(const PathResult& result) {
     }
 }
 
+void PathfindingVisualizer::buildContractionHierarchy(Metric metric, unsigned threads) {
+    ChBuildOptions options;
+    options.metric = metric;
+    options.threads = threads;
+    hierarchy = ContractionHierarchy::build(getRoadGraph(), options);
+}
+
+DistanceMatrix PathfindingVisualizer::distanceMatrix(const std::vector<std::string>& sources,
+                                                    const std::vector<std::string>& targets,
+                                                    Metric metric, unsigned threads, DistanceMatrix* alongPath) {
+    const RoadGraph& g = getRoadGraph();
+    std::vector<NodeId> sourceIds, targetIds;
+    for (const auto& name : sources) sourceIds.push_back(getCityId(name));
+    for (const auto& name : targets) targetIds.push_back(getCityId(name));
+    
+    // Shortcut weights only carry one metric, so the other-metric table needs the plain graph
+    if (!alongPath && !hierarchy.empty() && hierarchy.getMetric() == metric) {
+        return DistanceMatrix::compute(hierarchy, sourceIds, targetIds, threads);
+    }
+    return DistanceMatrix::compute(g, sourceIds, targetIds, metric, threads, alongPath);
+}
+
+void PathfindingVisualizer::buildLandmarks(size_t count, LandmarkSelection selection, unsigned threads) {
+    LandmarkOptions options;
+    options.count = count;
+    options.selection = selection;
+    options.threads = threads;
+    
+    options.metric = Metric::Distance;
+    distanceLandmarks = LandmarkTable::build(getRoadGraph(), options);
+    options.metric = Metric::Time;
+    timeLandmarks = LandmarkTable::build(getRoadGraph(), options);
+}
+
+bool PathfindingVisualizer::saveContractionHierarchy(const std::string& filename) {
+    if (hierarchy.empty()) {
+        std::cerr << "No contraction hierarchy to save" << std::endl;
+        return false;
+    }
+    return hierarchy.save(filename);
+}
+
+bool PathfindingVisualizer::loadContractionHierarchy(const std::string& filename) {
+    ContractionHierarchy loaded;
+    if (!loaded.load(filename)) {
+        return false;
+    }
+    if (!loaded.matches(getRoadGraph())) {
+        std::cerr << "Hierarchy does not match the current graph: " << filename << std::endl;
+        return false;
+    }
+    hierarchy = std::move(loaded);
+    return true;
+}
+
 void PathfindingVisualizer::exportResults(const std::vector<PathResult>& results, const std::string& filename) {
     std::ofstream file(filename);
     if (!file.is_open()) {
@@ -326,61 +815,91 @@ void PathfindingVisualizer::exportResults(const std::vector<PathResult>& results
         }
         file << "\n";
         file << "Total Distance: " << result.totalDistance << " km\n";
-        file << "Total Time: " << result.totalTime << " hours\n\n";
+        file << "Total Time: " << result.totalTime << " hours\n";
+        if (result.nodesExpanded > 0) {
+            file << "Nodes Expanded: " << result.nodesExpanded << "\n";
+        }
+        file << "\n";
     }
     
     file.close();
 }
 
 void PathfindingVisualizer::loadCitiesFromFile(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
+    std::vector<City> parsed;
+    if (!parseCitiesFile(filename, parsed)) {
         std::cerr << "Error opening cities file: " << filename << std::endl;
         return;
     }
     
-    cities.clear();
-    std::string line;
-    
-    while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        std::string name;
-        double lat, lon;
-        
-        if (iss >> name >> lat >> lon) {
-            cities.emplace_back(name, lat, lon);
-        }
-    }
-    
-    file.close();
+    recoverCityLists(); // keeps the routes
+    cities = std::move(parsed);
     buildGraph();
 }
 
 void PathfindingVisualizer::loadRoutesFromFile(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
+    std::vector<Route> parsed;
+    if (!parseRoutesFile(filename, parsed)) {
         std::cerr << "Error opening routes file: " << filename << std::endl;
         return;
     }
     
-    routes.clear();
-    std::string line;
-    
-    while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        std::string from, to;
-        double distance, time;
-        
-        if (iss >> from >> to >> distance >> time) {
-            routes.emplace_back(from, to, distance, time);
-        }
+    recoverCityLists(); // keeps the cities
+    routes = std::move(parsed);
+    buildGraph();
+}
+
+bool PathfindingVisualizer::loadNetworkFromFiles(const std::string& citiesFile, const std::string& routesFile) {
+    std::vector<City> parsedCities;
+    std::vector<Route> parsedRoutes;
+    if (!parseCitiesFile(citiesFile, parsedCities)) {
+        std::cerr << "Error opening cities file: " << citiesFile << std::endl;
+        return false;
+    }
+    if (!parseRoutesFile(routesFile, parsedRoutes)) {
+        std::cerr << "Error opening routes file: " << routesFile << std::endl;
+        return false;
     }
     
-    file.close();
+    cities = std::move(parsedCities);
+    routes = std::move(parsedRoutes);
+    cityListsStale = false;
     buildGraph();
+    return true;
+}
+
+bool PathfindingVisualizer::saveSnapshot(const std::string& filename) {
+    return getRoadGraph().save(filename);
+}
+
+bool PathfindingVisualizer::loadSnapshot(const std::string& filename) {
+    RoadGraph loaded;
+    if (!loaded.load(filename)) {
+        return false;
+    }
+    if (loaded.nodeCount() > 0 && !loaded.hasCoordinates()) {
+        std::cerr << "Snapshot has no city coordinates: " << filename << std::endl;
+        return false;
+    }
+    // Every query resolves names through cityIndex, so nameless nodes would
+    // all collapse onto one empty name
+    if (loaded.nodeCount() > 0 && !loaded.hasNames()) {
+        std::cerr << "Snapshot has no city names: " << filename << std::endl;
+        return false;
+    }
+    
+    cities.clear();
+    routes.clear();
+    graph.clear();
+    cityListsStale = true;
+    directedRoutes = loaded.isDirected();
+    graphVersion++;
+    installRoadGraph(std::move(loaded));
+    return true;
 }
 
 void PathfindingVisualizer::analyzeGraphProperties() {
+    ensureCityLists();
     std::cout << "Graph Analysis:\n";
     std::cout << "Cities: " << cities.size() << std::endl;
     std::cout << "Routes: " << routes.size() << std::endl;
@@ -396,86 +915,61 @@ void PathfindingVisualizer::analyzeGraphProperties() {
 }
 
 void PathfindingVisualizer::findConnectedComponents() {
-    std::map<std::string, bool> visited;
-    std::vector<std::vector<std::string>> components;
-    
-    // Initialize visited map
-    for (const auto& city : cities) {
-        visited[city.name] = false;
-    }
+    const RoadGraph& g = getRoadGraph();
+    ConnectedComponents components = connectedComponents();
     
-    // DFS to find connected components
-    for (const auto& city : cities) {
-        if (!visited[city.name]) {
-            std::vector<std::string> component;
-            std::stack<std::string> stack;
-            
-            stack.push(city.name);
-            visited[city.name] = true;
-            
-            while (!stack.empty()) {
-                std::string current = stack.top();
-                stack.pop();
-                component.push_back(current);
-                
-                for (const auto& neighbor : graph[current]) {
-                    if (!visited[neighbor.first]) {
-                        visited[neighbor.first] = true;
-                        stack.push(neighbor.first);
-                    }
-                }
-            }
-            
-            components.push_back(component);
-        }
+    std::vector<std::vector<NodeId>> members(components.componentCount());
+    for (NodeId node = 0; node < g.nodeCount(); ++node) {
+        members[components.label[node]].push_back(node);
     }
     
-    std::cout << "Connected Components: " << components.size() << std::endl;
-    for (size_t i = 0; i < components.size(); ++i) {
-        std::cout << "Component " << (i + 1) << " (" << components[i].size() << " cities): ";
-        for (const auto& city : components[i]) {
-            std::cout << city << " ";
+    std::cout << "Connected Components: " << components.componentCount() << std::endl;
+    for (size_t i = 0; i < members.size(); ++i) {
+        std::cout << "Component " << (i + 1) << " (" << components.sizes[i] << " cities): ";
+        for (NodeId node : members[i]) {
+            std::cout << g.name(node) << " ";
         }
         std::cout << std::endl;
     }
 }
 
-void PathfindingVisualizer::calculateAveragePathLength() {
-    double totalLength = 0.0;
-    int pathCount = 0;
+ConnectedComponents PathfindingVisualizer::connectedComponents(ComponentAlgorithm algorithm, unsigned threads) {
+    return ConnectedComponents::compute(getRoadGraph(), algorithm, threads);
+}
+
+AllPairsStats PathfindingVisualizer::analyzeAllPairs(Metric metric, unsigned threads) {
+    const RoadGraph& g = getRoadGraph();
+    AllPairsStats stats = AllPairsStats::compute(g, metric, threads);
+    std::string unit = metric == Metric::Distance ? " km" : " hours";
     
-    for (size_t i = 0; i < cities.size(); ++i) {
-        for (size_t j = i + 1; j < cities.size(); ++j) {
-            PathResult result = dijkstra(cities[i].name, cities[j].name);
-            if (!result.path.empty()) {
-                totalLength += result.totalDistance;
-                pathCount++;
-            }
-        }
+    if (stats.reachablePairs == 0) {
+        std::cout << "No connected city pairs" << std::endl;
+        return stats;
     }
     
-    if (pathCount > 0) {
-        std::cout << "Average shortest path length: " 
-                  << (totalLength / pathCount) << " km" << std::endl;
-    }
-}
-
-// Private helper functions
-std::string PathfindingVisualizer::findMinDistanceCity(const std::map<std::string, double>& distances, 
-                                                      const std::set<std::string>& unvisited) {
-    std::string minCity;
-    double minDistance = std::numeric_limits<double>::infinity();
+    std::cout << "Connected pairs: " << stats.reachablePairs
+              << " (unreachable: " << stats.unreachablePairs << ")" << std::endl;
+    std::cout << "Average shortest path length: " << stats.averageDistance << unit << std::endl;
+    std::cout << "Diameter: " << stats.diameter << unit << " ("
+              << g.name(stats.diameterSource) << " -> " << g.name(stats.diameterTarget) << ")" << std::endl;
+    std::cout << "Radius: " << stats.radius << unit << " (center: " << g.name(stats.center) << ")" << std::endl;
     
-    for (const auto& city : unvisited) {
-        if (distances.at(city) < minDistance) {
-            minDistance = distances.at(city);
-            minCity = city;
-        }
+    std::cout << "Eccentricities:\n";
+    for (NodeId node = 0; node < g.nodeCount(); ++node) {
+        std::cout << "  " << g.name(node) << ": " << stats.eccentricity[node] << unit << std::endl;
     }
     
-    return minCity;
+    std::cout << "Distance histogram:\n";
+    size_t largest = *std::max_element(stats.histogram.begin(), stats.histogram.end());
+    for (size_t i = 0; i < stats.histogram.size(); ++i) {
+        size_t bar = largest > 0 ? (stats.histogram[i] * 40 + largest - 1) / largest : 0;
+        std::cout << "  [" << i * stats.binWidth << ", " << (i + 1) * stats.binWidth << ")" << unit
+                  << ": " << stats.histogram[i] << " " << std::string(bar, '#') << std::endl;
+    }
+    return stats;
 }
 
+// Private helper functions
 std::vector<std::string> PathfindingVisualizer::reconstructPath(const std::map<std::string, std::string>& previous,
                                                                const std::string& source, 
                                                                const std::string& destination) {
@@ -513,6 +1007,7 @@ double PathfindingVisualizer::haversineDistance(double lat1, double lon1, double
 
 // Additional helper functions for path calculations
 double PathfindingVisualizer::calculateTotalDistance(const std::vector<std::string>& path) {
+    ensureCityLists();
     double total = 0.0;
     for (size_t i = 0; i < path.size() - 1; ++i) {
         if (graph[path[i]].find(path[i + 1]) != graph[path[i]].end()) {
@@ -523,6 +1018,7 @@ double PathfindingVisualizer::calculateTotalDistance(const std::vector<std::stri
 }
 
 double PathfindingVisualizer::calculateTotalTime(const std::vector<std::string>& path) {
+    ensureCityLists();
     double total = 0.0;
     for (size_t i = 0; i < path.size() - 1; ++i) {
         if (graph[path[i]].find(path[i + 1]) != graph[path[i]].end()) {
@@ -533,6 +1029,7 @@ double PathfindingVisualizer::calculateTotalTime(const std::vector<std::string>&
 }
 
 std::vector<Route> PathfindingVisualizer::getRouteDetails(const std::vector<std::string>& path) {
+    ensureCityLists();
     std::vector<Route> details;
     for (size_t i = 0; i < path.size() - 1; ++i) {
         if (graph[path[i]].find(path[i + 1]) != graph[path[i]].end()) {
@@ -542,24 +1039,120 @@ std::vector<Route> PathfindingVisualizer::getRouteDetails(const std::vector<std:
     return details;
 }
 
-void PathfindingVisualizer::dfsHelper(const std::string& current, const std::string& destination, 
-                                     std::map<std::string, bool>& visited, 
-                                     std::map<std::string, std::string>& previous,
-                                     bool& found) {
-    if (found) return; // Stop if path already found
+void PathfindingVisualizer::rebuildRoadGraph() {
+    ensureCityLists();
+    std::unordered_map<std::string, NodeId> index;
+    std::vector<std::string> names;
+    std::vector<double> latitudes, longitudes;
     
-    visited[current] = true;
+    for (const auto& city : cities) {
+        if (index.emplace(city.name, static_cast<NodeId>(names.size())).second) {
+            names.push_back(city.name);
+            latitudes.push_back(city.latitude);
+            longitudes.push_back(city.longitude);
+        }
+    }
     
-    if (current == destination) {
-        found = true;
-        return;
+    // Routes to cities missing from the city list are skipped, matching the
+    // map-based algorithms which never visit such cities either
+    std::vector<RoadEdge> edges;
+    edges.reserve(routes.size());
+    for (const auto& route : routes) {
+        auto from = index.find(route.from);
+        auto to = index.find(route.to);
+        if (from != index.end() && to != index.end()) {
+            edges.emplace_back(from->second, to->second, route.distance, route.time);
+        }
     }
     
-    // Explore all neighbors
-    for (const auto& neighbor : graph[current]) {
-        if (!visited[neighbor.first] && !found) {
-            previous[neighbor.first] = current;
-            dfsHelper(neighbor.first, destination, visited, previous, found);
+    RoadGraph built = RoadGraph::fromEdges(names.size(), edges, !directedRoutes);
+    built.setNodeInfo(std::move(names), std::move(latitudes), std::move(longitudes));
+    if (nodeOrdering != NodeOrdering::Original) {
+        built = built.renumbered(computeNodeOrder(built, nodeOrdering));
+    }
+    installRoadGraph(std::move(built));
+}
+
+void PathfindingVisualizer::installRoadGraph(RoadGraph graph) {
+    roadGraph = std::move(graph);
+    cityIndex.clear();
+    for (NodeId node = 0; node < roadGraph.nodeCount(); ++node) {
+        cityIndex.emplace(roadGraph.name(node), node);
+    }
+    geoHeuristic.build(roadGraph);
+    spatialIndex = SpatialIndex::build(roadGraph);
+    hierarchy = ContractionHierarchy();
+    distanceLandmarks = LandmarkTable();
+    timeLandmarks = LandmarkTable();
+    roadGraphDirty = false;
+}
+
+bool PathfindingVisualizer::parseCitiesFile(const std::string& filename, std::vector<City>& parsed) {
+    MappedFile file;
+    if (!file.open(filename)) {
+        return false;
+    }
+    
+    const char* cursor = file.data();
+    const char* end = cursor + file.size();
+    std::string_view tokens[3];
+    double lat, lon;
+    while (cursor < end) {
+        if (nextLineTokens(cursor, end, tokens, 3) == 3 &&
+            parseDouble(tokens[1], lat) && parseDouble(tokens[2], lon)) {
+            parsed.emplace_back(std::string(tokens[0]), lat, lon);
         }
     }
+    return true;
+}
+
+bool PathfindingVisualizer::parseRoutesFile(const std::string& filename, std::vector<Route>& parsed) {
+    MappedFile file;
+    if (!file.open(filename)) {
+        return false;
+    }
+    
+    const char* cursor = file.data();
+    const char* end = cursor + file.size();
+    std::string_view tokens[4];
+    double distance, time;
+    while (cursor < end) {
+        if (nextLineTokens(cursor, end, tokens, 4) == 4 &&
+            parseDouble(tokens[2], distance) && parseDouble(tokens[3], time)) {
+            parsed.emplace_back(std::string(tokens[0]), std::string(tokens[1]), distance, time);
+        }
+    }
+    return true;
+}
+
+PathResult PathfindingVisualizer::makePathResult(const std::vector<NodeId>& nodePath, const std::string& algorithm) {
+    PhaseTimer timer(queryStats, SearchPhase::Unpack);
+    PathResult result;
+    result.algorithm = algorithm;
+    
+    for (size_t i = 0; i < nodePath.size(); ++i) {
+        result.path.push_back(roadGraph.name(nodePath[i]));
+        if (i + 1 < nodePath.size()) {
+            EdgeId edge = roadGraph.findEdge(nodePath[i], nodePath[i + 1]);
+            if (edge == INVALID_EDGE) {
+                // Consecutive nodes must be joined by an arc; anything else is no route
+                std::cerr << "Path step has no edge: " << roadGraph.name(nodePath[i]) << " -> "
+                          << roadGraph.name(nodePath[i + 1]) << std::endl;
+                PathResult empty;
+                empty.algorithm = algorithm;
+                return empty;
+            }
+            result.totalDistance += roadGraph.distance(edge);
+            result.totalTime += roadGraph.time(edge);
+            result.routeDetails.emplace_back(roadGraph.name(nodePath[i]), roadGraph.name(nodePath[i + 1]),
+                                             roadGraph.distance(edge), roadGraph.time(edge));
+        }
+    }
+    
+    return result;
+}
+
+void PathfindingVisualizer::recordWork(PathResult& result, const SearchStats& work) {
+    result.stats = work;
+    result.nodesExpanded = work.settled;
 }
@@ -7,6 +7,22 @@
 #include <set>
 #include <queue>
 #include <limits>
+#include <unordered_map>
+#include "road_graph.h"
+#include "shortest_path.h"
+#include "contraction_hierarchy.h"
+#include "landmarks.h"
+#include "graph_analytics.h"
+#include "distance_matrix.h"
+#include "connected_components.h"
+#include "delta_stepping.h"
+#include "graph_traversal.h"
+#include "graph_ordering.h"
+#include "spatial_index.h"
+#include "search_stats.h"
+#include "pareto_search.h"
+#include "query_cache.h"
+#include "parallel.h"
 
 /**
  * Pathfinding Algorithms Implementation
@@ -28,6 +44,7 @@ struct Route {
     double distance; // in kilometers
     double time;     // in hours
     
+    Route() : distance(0.0), time(0.0) {}
     Route(const std::string& f, const std::string& t, double dist, double t_time)
         : from(f), to(t), distance(dist), time(t_time) {}
 };
@@ -38,8 +55,19 @@ struct PathResult {
     double totalTime;
     std::vector<Route> routeDetails;
     std::string algorithm;
+    size_t nodesExpanded; // 0 for the map-based algorithms, which do not count
+    SearchStats stats;    // work and phase times of the query that returned this result
     
-    PathResult() : totalDistance(0.0), totalTime(0.0) {}
+    PathResult() : totalDistance(0.0), totalTime(0.0), nodesExpanded(0) {}
+};
+
+struct QueryCacheStats {
+    size_t resultHits;
+    size_t resultMisses;
+    size_t resultEntries;
+    size_t treeHits;
+    size_t treeMisses;
+    size_t treeEntries;
 };
 
 class PathfindingVisualizer {
@@ -48,6 +76,38 @@ private:
     std::vector<Route> routes;
     std::map<std::string, std::map<std::string, Route>> graph;
     
+    // Compact integer-indexed copy of the graph, rebuilt lazily after edits
+    RoadGraph roadGraph;
+    std::unordered_map<std::string, NodeId> cityIndex;
+    bool roadGraphDirty;
+    bool cityListsStale; // cities, routes and graph not yet recovered from a loaded snapshot
+    bool adjacencyStale; // graph not yet rebuilt from the current cities and routes
+    bool directedRoutes; // false mirrors every route, as the original data assumes
+    NodeOrdering nodeOrdering; // applied to the compact graph on every rebuild
+    DijkstraSearch dijkstraSearch;
+    BidirectionalSearch bidirectionalSearch;
+    DeltaSteppingSearch deltaSteppingSearch;
+    ParetoSearch paretoSearch;
+    BreadthFirstSearch breadthFirstSearchEngine;
+    GeoHeuristic geoHeuristic;
+    SpatialIndex spatialIndex; // k-d tree over city coordinates for snapping
+    ContractionHierarchy hierarchy; // empty until built, dropped when the graph changes
+    ChQuery hierarchyQuery;
+    LandmarkTable distanceLandmarks; // empty until built, dropped when the graph changes
+    LandmarkTable timeLandmarks;
+    
+    // Query caches; entries are tagged with graphVersion, which every edit bumps
+    static const uint32_t HOT_SOURCE_QUERIES = 3; // queries from one source before its full tree is cached
+    uint64_t graphVersion;
+    bool queryCacheEnabled;
+    ShardedLruCache<QueryKey, PathResult, QueryKeyHash> resultCache;
+    ShardedLruCache<TreeKey, std::shared_ptr<const ShortestPathTree>, TreeKeyHash> treeCache;
+    std::unordered_map<NodeId, uint32_t> sourceQueryCounts; // since sourceCountsVersion
+    uint64_t sourceCountsVersion;
+    
+    SearchStats queryStats; // phase times of the query in flight
+    QueryStatsCollector queryStatsCollector;
+    
 public:
     PathfindingVisualizer();
     
@@ -55,11 +115,40 @@ public:
     void buildGraph();
     void addCity(const City& city);
     void addRoute(const Route& route);
+    // Live updates: reweights existing roads in place on the compact graph
+    // (new roads rebuild it) and repairs the cached shortest-path trees
+    // instead of dropping them. Point-to-point results and the contraction
+    // hierarchy are invalidated; landmarks survive weight increases. Returns
+    // the number of nodes settled while repairing trees.
+    size_t updateRoutes(const std::vector<Route>& updates);
+    void setDirectedRoutes(bool directed);
+    bool hasDirectedRoutes() const { return directedRoutes; }
+    // Renumbers the compact graph for memory locality (city order by
+    // default); large imports should use preferredOrdering, i.e. Hilbert
+    void setNodeOrdering(NodeOrdering ordering);
+    NodeOrdering getNodeOrdering() const { return nodeOrdering; }
     
     // Pathfinding algorithms
-    PathResult dijkstra(const std::string& source, const std::string& destination);
+    PathResult dijkstra(const std::string& source, const std::string& destination,
+                        QueueType queue = QueueType::QuaternaryHeap);
+    PathResult aStar(const std::string& source, const std::string& destination,
+                     HeuristicMode mode = HeuristicMode::Haversine);
+    PathResult bidirectionalDijkstra(const std::string& source, const std::string& destination);
+    PathResult bidirectionalAStar(const std::string& source, const std::string& destination);
+    PathResult altSearch(const std::string& source, const std::string& destination,
+                         Metric metric = Metric::Distance);
+    // Parallel single-source search (same distances as dijkstra)
+    PathResult deltaStepping(const std::string& source, const std::string& destination,
+                             unsigned threads = defaultThreadCount());
+    PathResult contractionHierarchyQuery(const std::string& source, const std::string& destination);
     PathResult breadthFirstSearch(const std::string& source, const std::string& destination);
     PathResult depthFirstSearch(const std::string& source, const std::string& destination);
+    // Snaps both positions to their nearest cities, then runs dijkstra
+    PathResult routeBetweenCoordinates(double fromLatitude, double fromLongitude,
+                                       double toLatitude, double toLongitude);
+    // Every Pareto-optimal (distance, time) route, shortest first and fastest
+    // last; empty when either city is unknown or unreachable
+    std::vector<PathResult> paretoRoutes(const std::string& source, const std::string& destination);
     
     // Algorithm comparison
     std::vector<PathResult> compareAlgorithms(const std::string& source, const std::string& destination);
@@ -68,6 +157,11 @@ public:
     double calculateHeuristic(const std::string& city1, const std::string& city2);
     std::vector<std::string> getNeighbors(const std::string& city);
     bool cityExists(const std::string& cityName);
+    const RoadGraph& getRoadGraph();
+    NodeId getCityId(const std::string& cityName);
+    // Closest city to a position, empty when there are no cities
+    std::string nearestCity(double latitude, double longitude);
+    const SpatialIndex& getSpatialIndex();
     void printPath(const PathResult& result);
     
     // Path calculation functions
@@ -75,25 +169,78 @@ public:
     double calculateTotalTime(const std::vector<std::string>& path);
     std::vector<Route> getRouteDetails(const std::vector<std::string>& path);
     
+    // Contraction Hierarchies preprocessing (queries need a built or loaded hierarchy)
+    void buildContractionHierarchy(Metric metric = Metric::Distance, unsigned threads = defaultThreadCount());
+    bool saveContractionHierarchy(const std::string& filename);
+    bool loadContractionHierarchy(const std::string& filename);
+    bool hasContractionHierarchy() const { return !hierarchy.empty(); }
+    
+    // ALT landmark preprocessing, one table per metric
+    void buildLandmarks(size_t count = 16, LandmarkSelection selection = LandmarkSelection::Avoid,
+                        unsigned threads = defaultThreadCount());
+    bool hasLandmarks() const { return !distanceLandmarks.empty(); }
+    
     // Data export/import
     void exportResults(const std::vector<PathResult>& results, const std::string& filename);
+    // Text loaders map the file and parse it in place ("name lat lon" and
+    // "from to distance time" per line); loadNetworkFromFiles builds the graph once for both
     void loadCitiesFromFile(const std::string& filename);
     void loadRoutesFromFile(const std::string& filename);
+    bool loadNetworkFromFiles(const std::string& citiesFile, const std::string& routesFile);
+    // Binary snapshot of the compact graph; loading skips parsing and the CSR
+    // build, and the city and route lists are only recovered when first used.
+    // Snapshots without city names or coordinates are rejected
+    bool saveSnapshot(const std::string& filename);
+    bool loadSnapshot(const std::string& filename);
+    
+    // Query caching (on by default); hit and miss counters are cumulative
+    void setQueryCacheEnabled(bool enabled);
+    bool isQueryCacheEnabled() const { return queryCacheEnabled; }
+    void clearQueryCache();
+    QueryCacheStats getQueryCacheStats();
+    
+    // Per-query instrumentation: every query through the caches is recorded
+    // into latency and work histograms per algorithm, in PATHFINDING_STATS
+    // builds only (make STATS=1)
+    const QueryStatsCollector& getQueryStats() const { return queryStatsCollector; }
+    void clearQueryStats() { queryStatsCollector.clear(); }
+    bool exportQueryStats(const std::string& filename) const { return queryStatsCollector.exportJson(filename); }
+    
+    // Batched N x M cost matrix (row-major, INFINITE_WEIGHT when unreachable or unknown).
+    // Uses the contraction hierarchy when one is built for `metric`, otherwise
+    // one search tree per source; `alongPath` receives the other metric when given.
+    DistanceMatrix distanceMatrix(const std::vector<std::string>& sources, const std::vector<std::string>& targets,
+                                  Metric metric = Metric::Distance, unsigned threads = defaultThreadCount(),
+                                  DistanceMatrix* alongPath = nullptr);
     
     // Analysis functions
     void analyzeGraphProperties();
     void findConnectedComponents();
-    void calculateAveragePathLength();
+    // Component label per city id plus component sizes; findConnectedComponents prints them
+    ConnectedComponents connectedComponents(ComponentAlgorithm algorithm = ComponentAlgorithm::Afforest,
+                                            unsigned threads = defaultThreadCount());
+    // One full search per city across `threads` workers: average, diameter,
+    // eccentricities and a distance histogram
+    AllPairsStats analyzeAllPairs(Metric metric = Metric::Distance, unsigned threads = defaultThreadCount());
     
 private:
     // Helper functions for algorithms
-    std::string findMinDistanceCity(const std::map<std::string, double>& distances, const std::set<std::string>& unvisited);
+    void rebuildRoadGraph();
+    void buildAdjacencyMap();
+    void ensureCityLists();
+    void recoverCityLists();
+    void installRoadGraph(RoadGraph graph);
+    bool parseCitiesFile(const std::string& filename, std::vector<City>& parsed);
+    bool parseRoutesFile(const std::string& filename, std::vector<Route>& parsed);
+    PathResult makePathResult(const std::vector<NodeId>& nodePath, const std::string& algorithm);
+    void recordWork(PathResult& result, const SearchStats& work);
+    template <typename Compute>
+    PathResult cachedQuery(const std::string& source, const std::string& destination, Metric metric,
+                           const std::string& algorithm, uint32_t variant, Compute compute);
+    std::shared_ptr<const ShortestPathTree> hotSourceTree(NodeId source, Metric metric);
     std::vector<std::string> reconstructPath(const std::map<std::string, std::string>& previous, 
                                            const std::string& source, const std::string& destination);
     double haversineDistance(double lat1, double lon1, double lat2, double lon2);
-    void dfsHelper(const std::string& current, const std::string& destination, 
-                  std::map<std::string, bool>& visited, std::map<std::string, std::string>& previous,
-                  bool& found);
 };
 
 #endif // PATHFINDING_H
@@ -0,0 +1,983 @@
+#include "road_graph.h"
+#include "shortest_path.h"
+#include "contraction_hierarchy.h"
+#include "landmarks.h"
+#include "graph_analytics.h"
+#include "distance_matrix.h"
+#include "mapped_file.h"
+#include "graph_generators.h"
+#include "shortest_path_tree.h"
+#include "connected_components.h"
+#include "delta_stepping.h"
+#include "graph_traversal.h"
+#include "graph_ordering.h"
+#include "spatial_index.h"
+#include "search_stats.h"
+#include "pareto_search.h"
+#include "parallel.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <cstdlib>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <functional>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <cstring>
+
+/**
+ * Pathfinding Benchmark
+ * Runs random point-to-point query workloads on synthetic road-like graphs
+ * Usage: pathfinding_bench [grid|geometric|scalefree] [nodes] [queries]
+ */
+
+// Graphs above this size skip Contraction Hierarchies preprocessing; hub-heavy
+// scale-free graphs contract far worse than road-like ones
+static const size_t CH_NODE_LIMIT = 200000;
+static const size_t CH_SCALE_FREE_NODE_LIMIT = 10000;
+
+// Pareto searches are orders of magnitude costlier than single-criterion
+// ones; the label cap keeps a plain search on a large graph within memory
+static const size_t PARETO_QUERIES = 20;
+static const size_t PARETO_LABEL_LIMIT = 4000000;
+
+struct WorkloadStats {
+    double averageMicros;
+    double p50Micros;
+    double p90Micros;
+    double p99Micros;
+    double maxMicros;
+    size_t averageSettled;
+    bool correct;
+};
+
+// Times every query on its own; query(i) runs query i and returns its
+// (distance, settled nodes), which is checked against reference[i]
+static WorkloadStats measureWorkload(size_t count, const std::vector<double>& reference, double tolerance,
+                                     const std::function<std::pair<double, size_t>(size_t)>& query) {
+    WorkloadStats stats = {};
+    stats.correct = true;
+    std::vector<double> micros(count);
+    size_t settled = 0;
+    double total = 0.0;
+
+    for (size_t i = 0; i < count; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+        std::pair<double, size_t> result = query(i);
+        auto end = std::chrono::high_resolution_clock::now();
+        micros[i] = std::chrono::duration<double, std::micro>(end - start).count();
+        total += micros[i];
+        settled += result.second;
+        if (std::abs(result.first - reference[i]) > tolerance) {
+            stats.correct = false;
+        }
+    }
+
+    if (count > 0) {
+        std::sort(micros.begin(), micros.end());
+        auto percentile = [&](double p) { return micros[std::min(count - 1, static_cast<size_t>(p * count))]; };
+        stats.averageMicros = total / count;
+        stats.p50Micros = percentile(0.50);
+        stats.p90Micros = percentile(0.90);
+        stats.p99Micros = percentile(0.99);
+        stats.maxMicros = micros.back();
+        stats.averageSettled = settled / count;
+    }
+    return stats;
+}
+
+static void printWorkload(const std::string& name, const WorkloadStats& stats) {
+    std::cout << "  " << std::setw(16) << std::left << name << std::right << std::fixed << std::setprecision(0)
+              << "Avg: " << std::setw(8) << stats.averageMicros << " μs, "
+              << "p50: " << std::setw(8) << stats.p50Micros << ", "
+              << "p90: " << std::setw(8) << stats.p90Micros << ", "
+              << "p99: " << std::setw(8) << stats.p99Micros << ", "
+              << "Settled: " << stats.averageSettled << ", "
+              << "Correct: " << (stats.correct ? "Yes" : "No") << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+}
+
+// Hardware cache-miss counter for this process; reads -1 where perf events
+// are not available (containers, most VMs)
+class CacheMissCounter {
+private:
+    int fd;
+
+public:
+    CacheMissCounter() {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+    ~CacheMissCounter() {
+        if (fd >= 0) close(fd);
+    }
+    CacheMissCounter(const CacheMissCounter&) = delete;
+    CacheMissCounter& operator=(const CacheMissCounter&) = delete;
+
+    void start() {
+        if (fd < 0) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    long long stop() {
+        if (fd < 0) return -1;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        long long count = 0;
+        return read(fd, &count, sizeof(count)) == sizeof(count) ? count : -1;
+    }
+};
+
+// Reference for the spatial index checks
+static double greatCircleKm(double lat1, double lon1, double lat2, double lon2) {
+    double dLat = (lat2 - lat1) * M_PI / 180.0;
+    double dLon = (lon2 - lon1) * M_PI / 180.0;
+    double a = std::sin(dLat / 2) * std::sin(dLat / 2) +
+               std::cos(lat1 * M_PI / 180.0) * std::cos(lat2 * M_PI / 180.0) * std::sin(dLon / 2) * std::sin(dLon / 2);
+    return 2.0 * 6371.0 * std::asin(std::min(1.0, std::sqrt(a)));
+}
+
+static long peakResidentKiB() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss; // KiB on Linux
+}
+
+// width x width grid with integer edge weights minWeight..minWeight + 2 in
+// both criteria: many equal shortest paths, which stresses tie handling
+static RoadGraph tiedWeightGrid(size_t width, bool directed, unsigned seed, int minWeight = 1) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> weight(minWeight, minWeight + 2);
+    std::vector<RoadEdge> edges;
+    auto connect = [&](NodeId from, NodeId to) {
+        double w = weight(gen);
+        edges.emplace_back(from, to, w, w);
+        if (directed) {
+            w = weight(gen);
+            edges.emplace_back(to, from, w, w);
+        }
+    };
+    for (size_t y = 0; y < width; ++y) {
+        for (size_t x = 0; x < width; ++x) {
+            NodeId node = static_cast<NodeId>(y * width + x);
+            if (x + 1 < width) connect(node, node + 1);
+            if (y + 1 < width) connect(node, static_cast<NodeId>(node + width));
+        }
+    }
+    return RoadGraph::fromEdges(width * width, edges, !directed);
+}
+
+int main(int argc, char* argv[]) {
+    std::string kind = argc > 1 ? argv[1] : "grid";
+    size_t nodes = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 22500;
+    size_t queries = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 200;
+
+    std::cout << "=== Pathfinding Benchmark ===" << std::endl;
+    auto generateStart = std::chrono::high_resolution_clock::now();
+    RoadGraph graph = generateGraph(kind, nodes, 42);
+    auto generateEnd = std::chrono::high_resolution_clock::now();
+    if (graph.nodeCount() == 0) {
+        std::cerr << "Unknown graph kind: " << kind << " (expected grid, geometric or scalefree)" << std::endl;
+        return 1;
+    }
+    std::cout << "Graph: " << kind << ", " << graph.nodeCount() << " nodes, " << graph.edgeCount() << " arcs, "
+              << "generated in " << std::chrono::duration_cast<std::chrono::milliseconds>(generateEnd - generateStart).count()
+              << " ms, " << graph.memoryUsage() / 1024 << " KiB\n\n";
+
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<NodeId> pick(0, static_cast<NodeId>(graph.nodeCount() - 1));
+    std::vector<std::pair<NodeId, NodeId>> workload;
+    for (size_t i = 0; i < queries; ++i) {
+        workload.emplace_back(pick(gen), pick(gen));
+    }
+
+    // Reference distances from the lazy binary heap
+    DijkstraSearch search;
+    std::vector<double> reference;
+    for (const auto& query : workload) {
+        search.run(graph, query.first, query.second, Metric::Distance, QueueType::BinaryHeap);
+        reference.push_back(search.distanceTo(query.second));
+    }
+
+    std::cout << "Dijkstra priority queue comparison (" << queries << " queries):\n";
+    std::vector<QueueType> queues = {
+        QueueType::BinaryHeap, QueueType::QuaternaryHeap, QueueType::PairingHeap, QueueType::RadixHeap
+    };
+
+    for (QueueType queue : queues) {
+        printWorkload(queueTypeName(queue), measureWorkload(workload.size(), reference, 1e-9, [&](size_t i) {
+            search.run(graph, workload[i].first, workload[i].second, Metric::Distance, queue);
+            return std::make_pair(search.distanceTo(workload[i].second), search.settledCount());
+        }));
+    }
+
+    // Full single-source trees: sequential Dijkstra against delta-stepping
+    // at increasing thread counts; distances must match exactly, as must the
+    // targeted runs on the query workload
+    const size_t treeSources = std::min<size_t>(10, workload.size());
+    std::cout << "\nDelta-stepping (" << treeSources << " full trees, " << queries << " targeted, delta "
+              << DeltaSteppingSearch::autoDelta(graph, Metric::Distance) << " km):\n";
+    {
+        std::vector<std::vector<double>> trees;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < treeSources; ++i) {
+            search.run(graph, workload[i].first, INVALID_NODE, Metric::Distance);
+            std::vector<double> tree(graph.nodeCount());
+            for (NodeId node = 0; node < graph.nodeCount(); ++node) {
+                tree[node] = search.distanceTo(node);
+            }
+            trees.push_back(std::move(tree));
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double dijkstraMillis = std::chrono::duration<double, std::milli>(end - start).count();
+        std::cout << "  " << std::setw(16) << std::left << "Dijkstra" << std::fixed << std::setprecision(1)
+                  << dijkstraMillis / treeSources << " ms per tree" << std::endl;
+
+        std::vector<unsigned> threadCounts = {1, 2, 4, defaultThreadCount()};
+        std::sort(threadCounts.begin(), threadCounts.end());
+        threadCounts.erase(std::unique(threadCounts.begin(), threadCounts.end()), threadCounts.end());
+        DeltaSteppingSearch deltaStepping;
+        for (unsigned threads : threadCounts) {
+            bool identical = true;
+            start = std::chrono::high_resolution_clock::now();
+            for (size_t i = 0; i < treeSources; ++i) {
+                deltaStepping.run(graph, workload[i].first, INVALID_NODE, Metric::Distance, threads);
+                for (NodeId node = 0; identical && node < graph.nodeCount(); ++node) {
+                    identical = deltaStepping.distanceTo(node) == trees[i][node];
+                }
+            }
+            end = std::chrono::high_resolution_clock::now();
+            double millis = std::chrono::duration<double, std::milli>(end - start).count();
+            size_t treePhases = deltaStepping.phaseCount();
+
+            // Point-to-point runs stop early once the target's bucket is done
+            bool targetedCorrect = true;
+            for (size_t i = 0; i < workload.size(); ++i) {
+                deltaStepping.run(graph, workload[i].first, workload[i].second, Metric::Distance, threads);
+                if (deltaStepping.distanceTo(workload[i].second) != reference[i]) {
+                    targetedCorrect = false;
+                }
+            }
+            std::cout << "  " << std::setw(16) << std::left << ("Delta " + std::to_string(threads) + "T")
+                      << millis / treeSources << " ms per tree, "
+                      << "Speedup: " << dijkstraMillis / millis << "x, "
+                      << "Phases: " << treePhases << ", "
+                      << "Identical: " << (identical ? "Yes" : "No") << ", "
+                      << "Targeted: " << (targetedCorrect ? "Yes" : "No") << std::endl;
+        }
+
+        // Zero-weight roads tie a node with its neighbour; parent links must
+        // still lead back to the source along arcs of the reported length
+        RoadGraph zeroGrid = tiedWeightGrid(40, false, 42, 0);
+        bool zeroIdentical = true;
+        for (unsigned threads : threadCounts) {
+            for (NodeId source : {NodeId(0), NodeId(820)}) {
+                search.run(zeroGrid, source, INVALID_NODE, Metric::Distance);
+                deltaStepping.run(zeroGrid, source, INVALID_NODE, Metric::Distance, threads);
+                for (NodeId node = 0; zeroIdentical && node < zeroGrid.nodeCount(); ++node) {
+                    zeroIdentical = deltaStepping.distanceTo(node) == search.distanceTo(node);
+                    double length = 0.0;
+                    size_t steps = 0;
+                    NodeId current = node;
+                    for (; current != source && steps <= zeroGrid.nodeCount(); ++steps) {
+                        NodeId from = deltaStepping.parentOf(current);
+                        EdgeId edge = from == INVALID_NODE ? INVALID_EDGE : zeroGrid.findEdge(from, current);
+                        if (edge == INVALID_EDGE) break;
+                        length += zeroGrid.distance(edge);
+                        current = from;
+                    }
+                    zeroIdentical = zeroIdentical && current == source && length == search.distanceTo(node);
+                }
+            }
+        }
+        std::cout << "  " << std::setw(16) << std::left << "Zero weights" << "Identical: "
+                  << (zeroIdentical ? "Yes" : "No") << std::endl;
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
+    }
+
+    // Per-query counters and latency tails; queue counters and times are
+    // only collected in PATHFINDING_STATS builds (make STATS=1)
+    std::cout << "\nQuery instrumentation (" << queries << " Dijkstra queries, "
+              << (SEARCH_STATS_ENABLED ? "instrumented" : "not instrumented") << " build):\n";
+    {
+        QueryStatsCollector collector;
+        Histogram settled, peakQueue;
+        for (const auto& query : workload) {
+            SearchStats stats;
+            {
+                PhaseTimer timer(stats, SearchPhase::Search);
+                search.run(graph, query.first, query.second, Metric::Distance);
+            }
+            SearchStats work = search.searchStats();
+            work.phaseMicros[static_cast<size_t>(SearchPhase::Search)] =
+                stats.phaseMicros[static_cast<size_t>(SearchPhase::Search)];
+            collector.record("Dijkstra", work);
+            settled.add(work.settled);
+            peakQueue.add(work.peakQueueSize);
+        }
+        // Timers and queue counters read zero when compiled out, so say so
+        // rather than report them as measured
+        if constexpr (SEARCH_STATS_ENABLED) {
+            std::cout << "  Latency p50 / p90 / p99: " << collector.latencyPercentile("Dijkstra", 0.5) << " / "
+                      << collector.latencyPercentile("Dijkstra", 0.9) << " / "
+                      << collector.latencyPercentile("Dijkstra", 0.99) << " μs (bucket upper bounds)\n";
+        } else {
+            std::cout << "  Latency p50 / p90 / p99: n/a\n";
+        }
+        std::cout << "  Settled p50 / p99:       " << settled.percentile(0.5) << " / " << settled.percentile(0.99)
+                  << ", Peak queue p99: ";
+        if constexpr (SEARCH_STATS_ENABLED) {
+            std::cout << peakQueue.percentile(0.99) << std::endl;
+        } else {
+            std::cout << "n/a" << std::endl;
+        }
+        if (argc > 4) {
+            std::cout << "  Histograms: " << (collector.exportJson(argv[4]) ? argv[4] : "export failed") << std::endl;
+        }
+    }
+
+    std::cout << "\nA* heuristic comparison (" << queries << " queries):\n";
+    GeoHeuristic heuristic;
+    heuristic.build(graph);
+
+    struct Variant {
+        std::string name;
+        bool useHeuristic;
+        HeuristicMode mode;
+    };
+    std::vector<Variant> variants = {
+        {"Dijkstra", false, HeuristicMode::Haversine},
+        {"A* Haversine", true, HeuristicMode::Haversine},
+        {"A* Equirect", true, HeuristicMode::Equirectangular}
+    };
+
+    for (const auto& variant : variants) {
+        printWorkload(variant.name, measureWorkload(workload.size(), reference, 1e-9, [&](size_t i) {
+            if (variant.useHeuristic) {
+                search.runAStar(graph, workload[i].first, workload[i].second, Metric::Distance, heuristic, variant.mode);
+            } else {
+                search.run(graph, workload[i].first, workload[i].second);
+            }
+            return std::make_pair(search.distanceTo(workload[i].second), search.settledCount());
+        }));
+    }
+
+    std::cout << "\nBidirectional search comparison (" << queries << " queries):\n";
+    BidirectionalSearch bidirectional;
+    for (bool useHeuristic : {false, true}) {
+        std::string name = useHeuristic ? "Bidir A*" : "Bidir Dijkstra";
+        printWorkload(name, measureWorkload(workload.size(), reference, 1e-6, [&](size_t i) {
+            if (useHeuristic) {
+                bidirectional.runAStar(graph, workload[i].first, workload[i].second, Metric::Distance, heuristic);
+            } else {
+                bidirectional.run(graph, workload[i].first, workload[i].second);
+            }
+            return std::make_pair(bidirectional.distance(), bidirectional.settledCount());
+        }));
+    }
+
+    // Distance/time trade-off: the frontier's ends must match the two
+    // single-criterion optima
+    size_t paretoQueries = std::min(queries, PARETO_QUERIES);
+    std::cout << "\nPareto frontier (" << paretoQueries << " queries, distance x time, label cap "
+              << PARETO_LABEL_LIMIT << "):\n";
+    std::vector<double> fastest(paretoQueries);
+    for (size_t i = 0; i < paretoQueries; ++i) {
+        search.run(graph, workload[i].first, workload[i].second, Metric::Time);
+        fastest[i] = search.distanceTo(workload[i].second);
+    }
+    ParetoSearch pareto;
+    for (bool useHeuristic : {false, true}) {
+        std::vector<double> millis;
+        size_t frontierTotal = 0, frontierMax = 0, labels = 0, incomplete = 0;
+        bool correct = true;
+        for (size_t i = 0; i < paretoQueries; ++i) {
+            auto start = std::chrono::high_resolution_clock::now();
+            pareto.run(graph, workload[i].first, workload[i].second, useHeuristic ? &heuristic : nullptr,
+                       PARETO_LABEL_LIMIT);
+            auto end = std::chrono::high_resolution_clock::now();
+            millis.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+            labels += pareto.labelCount();
+            if (!pareto.isComplete()) {
+                incomplete++;
+                continue;
+            }
+            size_t size = pareto.frontierSize();
+            frontierTotal += size;
+            frontierMax = std::max(frontierMax, size);
+            if (size == 0) {
+                correct = correct && std::isinf(reference[i]);
+            } else if (std::abs(pareto.frontierPoint(0).distance - reference[i]) > 1e-6 ||
+                       std::abs(pareto.frontierPoint(size - 1).time - fastest[i]) > 1e-9) {
+                correct = false;
+            }
+        }
+        std::sort(millis.begin(), millis.end());
+        double average = 0.0;
+        for (double ms : millis) average += ms;
+        size_t complete = paretoQueries - incomplete;
+        std::cout << "  " << std::setw(16) << std::left << (useHeuristic ? "Pareto A*" : "Pareto") << std::right
+                  << std::fixed << std::setprecision(1)
+                  << "Avg: " << std::setw(8) << (paretoQueries > 0 ? average / paretoQueries : 0.0) << " ms, "
+                  << "p50: " << std::setw(8) << (paretoQueries > 0 ? millis[paretoQueries / 2] : 0.0) << ", "
+                  << "max: " << std::setw(8) << (paretoQueries > 0 ? millis.back() : 0.0) << ", "
+                  << "Frontier: " << (complete > 0 ? static_cast<double>(frontierTotal) / complete : 0.0)
+                  << " avg / " << frontierMax << " max, "
+                  << "Labels: " << (paretoQueries > 0 ? labels / paretoQueries : 0) << ", "
+                  << "Correct: " << (correct ? "Yes" : "No");
+        if (incomplete > 0) {
+            std::cout << " (" << incomplete << " hit the label cap)";
+        }
+        std::cout << std::endl;
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
+    }
+
+    std::cout << "\nALT landmarks:\n";
+    for (Metric metric : {Metric::Distance, Metric::Time}) {
+        std::vector<double> metricReference = reference;
+        if (metric == Metric::Time) {
+            for (size_t i = 0; i < workload.size(); ++i) {
+                search.run(graph, workload[i].first, workload[i].second, Metric::Time);
+                metricReference[i] = search.distanceTo(workload[i].second);
+            }
+        }
+
+        LandmarkOptions landmarkOptions;
+        landmarkOptions.metric = metric;
+        auto landmarkStart = std::chrono::high_resolution_clock::now();
+        LandmarkTable landmarks = LandmarkTable::build(graph, landmarkOptions);
+        auto landmarkEnd = std::chrono::high_resolution_clock::now();
+        std::string label = metric == Metric::Distance ? "ALT Distance" : "ALT Time";
+        std::cout << "  " << label << " preprocessing: "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(landmarkEnd - landmarkStart).count()
+                  << " ms, " << landmarks.getLandmarks().size() << " landmarks, "
+                  << landmarks.memoryUsage() / 1024 << " KiB\n";
+
+        printWorkload(label, measureWorkload(workload.size(), metricReference, 1e-9, [&](size_t i) {
+            search.runALT(graph, workload[i].first, workload[i].second, landmarks);
+            return std::make_pair(search.distanceTo(workload[i].second), search.settledCount());
+        }));
+    }
+
+    size_t matrixSize = std::min<size_t>(100, graph.nodeCount());
+    std::vector<NodeId> matrixSources, matrixTargets;
+    for (size_t i = 0; i < matrixSize; ++i) {
+        matrixSources.push_back(pick(gen));
+        matrixTargets.push_back(pick(gen));
+    }
+
+    size_t chLimit = kind == "scalefree" ? CH_SCALE_FREE_NODE_LIMIT : CH_NODE_LIMIT;
+    if (graph.nodeCount() > chLimit) {
+        std::cout << "\nContraction Hierarchies: skipped above " << chLimit << " nodes\n";
+    } else {
+        std::cout << "\nContraction Hierarchies:\n";
+        ChBuildOptions options;
+        auto buildStart = std::chrono::high_resolution_clock::now();
+        ContractionHierarchy ch = ContractionHierarchy::build(graph, options);
+        auto buildEnd = std::chrono::high_resolution_clock::now();
+        std::cout << "  Preprocessing: "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(buildEnd - buildStart).count() << " ms on "
+                  << options.threads << " thread(s), " << ch.shortcutCount() << " shortcuts, "
+                  << ch.memoryUsage() / 1024 << " KiB\n";
+
+        const std::string snapshot = "ch_bench.bin";
+        ContractionHierarchy loaded;
+        bool roundTrip = ch.save(snapshot) && loaded.load(snapshot);
+        std::remove(snapshot.c_str());
+        std::cout << "  Save/load round trip: " << (roundTrip ? "Yes" : "No") << std::endl;
+
+        ChQuery chQuery;
+        printWorkload("CH Query", measureWorkload(workload.size(), reference, 1e-6, [&](size_t i) {
+            chQuery.run(loaded, workload[i].first, workload[i].second);
+            return std::make_pair(chQuery.distance(), chQuery.settledCount());
+        }));
+
+        // Unpacked paths must be real edge sequences with the reported length
+        bool unpackCorrect = true;
+        for (size_t i = 0; i < std::min<size_t>(workload.size(), 20); ++i) {
+            if (reference[i] == INFINITE_WEIGHT) continue;
+            chQuery.run(loaded, workload[i].first, workload[i].second);
+            std::vector<NodeId> path = chQuery.path(loaded);
+            double length = 0.0;
+            for (size_t j = 0; j + 1 < path.size(); ++j) {
+                EdgeId edge = graph.findEdge(path[j], path[j + 1]);
+                length += edge == INVALID_EDGE ? INFINITE_WEIGHT : graph.distance(edge);
+            }
+            if (path.empty() || path.front() != workload[i].first || path.back() != workload[i].second ||
+                std::abs(length - reference[i]) > 1e-6) {
+                unpackCorrect = false;
+            }
+        }
+        std::cout << "  Unpacked paths valid: " << (unpackCorrect ? "Yes" : "No") << std::endl;
+
+        // Ties are where nodes contracted in the same batch could serve as
+        // each other's witness and leave a shortcut out
+        std::cout << "  Tied integer weights (40 x 40 grid, 400 queries) correct:";
+        for (bool directed : {false, true}) {
+            RoadGraph tied = tiedWeightGrid(40, directed, 42);
+            ContractionHierarchy tiedCh = ContractionHierarchy::build(tied, options);
+            std::uniform_int_distribution<NodeId> pickTied(0, static_cast<NodeId>(tied.nodeCount() - 1));
+            bool tiedCorrect = true;
+            for (size_t i = 0; i < 400; ++i) {
+                NodeId source = pickTied(gen);
+                NodeId target = pickTied(gen);
+                search.run(tied, source, target, Metric::Distance);
+                chQuery.run(tiedCh, source, target);
+                if (chQuery.distance() != search.distanceTo(target)) {
+                    tiedCorrect = false;
+                }
+            }
+            std::cout << (directed ? ", directed " : " undirected ") << (tiedCorrect ? "Yes" : "No");
+        }
+        std::cout << std::endl;
+
+        std::cout << "\nDistance matrix (" << matrixSize << " x " << matrixSize << "):\n";
+        auto matrixStart = std::chrono::high_resolution_clock::now();
+        DistanceMatrix treeMatrix = DistanceMatrix::compute(graph, matrixSources, matrixTargets);
+        auto matrixEnd = std::chrono::high_resolution_clock::now();
+        std::cout << "  " << std::setw(16) << std::left << "Search trees"
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(matrixEnd - matrixStart).count() << " ms\n";
+
+        matrixStart = std::chrono::high_resolution_clock::now();
+        DistanceMatrix bucketMatrix = DistanceMatrix::compute(loaded, matrixSources, matrixTargets);
+        matrixEnd = std::chrono::high_resolution_clock::now();
+        bool matrixCorrect = true;
+        for (size_t i = 0; i < treeMatrix.data().size(); ++i) {
+            if (std::abs(treeMatrix.data()[i] - bucketMatrix.data()[i]) > 1e-6) {
+                matrixCorrect = false;
+            }
+        }
+        std::cout << "  " << std::setw(16) << std::left << "CH buckets"
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(matrixEnd - matrixStart).count() << " ms, "
+                  << "Correct: " << (matrixCorrect ? "Yes" : "No") << std::endl;
+
+        // Cell for cell on tied integer weights, where bucket entries from
+        // different hub nodes reach a target at exactly the same distance
+        bool tiedMatrixCorrect = true;
+        for (bool directed : {false, true}) {
+            RoadGraph tied = tiedWeightGrid(40, directed, 42);
+            ContractionHierarchy tiedCh = ContractionHierarchy::build(tied, options);
+            std::vector<NodeId> tiedNodes;
+            for (NodeId node = 0; node < tied.nodeCount(); node += 8) {
+                tiedNodes.push_back(node);
+            }
+            DistanceMatrix plain = DistanceMatrix::compute(tied, tiedNodes, tiedNodes);
+            DistanceMatrix buckets = DistanceMatrix::compute(tiedCh, tiedNodes, tiedNodes);
+            if (plain.data() != buckets.data()) {
+                tiedMatrixCorrect = false;
+            }
+        }
+        std::cout << "  " << std::setw(16) << std::left << "Tied weights"
+                  << "Correct: " << (tiedMatrixCorrect ? "Yes" : "No") << std::endl;
+
+        matrixStart = std::chrono::high_resolution_clock::now();
+        for (NodeId source : matrixSources) {
+            for (NodeId target : matrixTargets) {
+                chQuery.run(loaded, source, target);
+            }
+        }
+        matrixEnd = std::chrono::high_resolution_clock::now();
+        std::cout << "  " << std::setw(16) << std::left << "CH pairwise"
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(matrixEnd - matrixStart).count() << " ms\n";
+    }
+
+    // All-pairs needs a full search per node, so use a small grid
+    RoadGraph statsGraph = generateGridGraph(50, 50, 42);
+    std::cout << "\nAll-pairs statistics (" << statsGraph.nodeCount() << " nodes):\n";
+    for (unsigned threads : {1u, defaultThreadCount()}) {
+        auto start = std::chrono::high_resolution_clock::now();
+        AllPairsStats stats = AllPairsStats::compute(statsGraph, Metric::Distance, threads);
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << "  " << threads << " thread(s): "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms, "
+                  << "Average: " << stats.averageDistance << " km, "
+                  << "Diameter: " << stats.diameter << " km" << std::endl;
+        if (threads == defaultThreadCount()) break;
+    }
+
+    // Components, checked against a sequential BFS labelling
+    std::cout << "\nConnected components (" << graph.nodeCount() << " nodes):\n";
+    {
+        std::vector<NodeId> reference(graph.nodeCount(), INVALID_NODE);
+        NodeId referenceCount = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<NodeId> frontier;
+        for (NodeId root = 0; root < graph.nodeCount(); ++root) {
+            if (reference[root] != INVALID_NODE) continue;
+            reference[root] = referenceCount;
+            frontier.assign(1, root);
+            while (!frontier.empty()) {
+                NodeId node = frontier.back();
+                frontier.pop_back();
+                for (EdgeId e = graph.firstEdge(node); e < graph.endEdge(node); ++e) {
+                    if (reference[graph.target(e)] == INVALID_NODE) {
+                        reference[graph.target(e)] = referenceCount;
+                        frontier.push_back(graph.target(e));
+                    }
+                }
+            }
+            referenceCount++;
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << "  " << std::setw(22) << std::left << "Sequential search"
+                  << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " μs, "
+                  << referenceCount << " component(s)" << std::endl;
+
+        for (ComponentAlgorithm algorithm : {ComponentAlgorithm::UnionFind, ComponentAlgorithm::Afforest}) {
+            for (unsigned threads : {1u, defaultThreadCount()}) {
+                start = std::chrono::high_resolution_clock::now();
+                ConnectedComponents components = ConnectedComponents::compute(graph, algorithm, threads);
+                end = std::chrono::high_resolution_clock::now();
+                std::string name = componentAlgorithmName(algorithm) + " (" + std::to_string(threads) + "T)";
+                std::cout << "  " << std::setw(22) << std::left << name
+                          << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " μs, "
+                          << "Largest: " << components.sizes[components.largestComponent()] << ", "
+                          << "Correct: " << (components.label == reference ? "Yes" : "No") << std::endl;
+                if (threads == defaultThreadCount()) break;
+            }
+        }
+    }
+
+    // Hop-count traversals: queue BFS as the reference for the
+    // direction-optimizing one, and DFS on a path long enough to overflow
+    // a recursive walk
+    std::cout << "\nTraversals (" << graph.nodeCount() << " nodes):\n";
+    {
+        NodeId root = workload[0].first;
+        std::vector<uint32_t> reference(graph.nodeCount(), UINT32_MAX);
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<NodeId> queue(1, root);
+        reference[root] = 0;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            NodeId node = queue[head];
+            for (EdgeId e = graph.firstEdge(node); e < graph.endEdge(node); ++e) {
+                if (reference[graph.target(e)] == UINT32_MAX) {
+                    reference[graph.target(e)] = reference[node] + 1;
+                    queue.push_back(graph.target(e));
+                }
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << "  " << std::setw(16) << std::left << "Queue BFS"
+                  << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " μs\n";
+
+        BreadthFirstSearch bfs;
+        for (unsigned threads : {1u, defaultThreadCount()}) {
+            start = std::chrono::high_resolution_clock::now();
+            bfs.run(graph, root, INVALID_NODE, threads);
+            end = std::chrono::high_resolution_clock::now();
+            bool correct = true;
+            for (NodeId node = 0; correct && node < graph.nodeCount(); ++node) {
+                correct = bfs.depthOf(node) == reference[node];
+            }
+            std::cout << "  " << std::setw(16) << std::left << ("Bitmap BFS " + std::to_string(threads) + "T")
+                      << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " μs, "
+                      << "Levels: " << bfs.topDownLevelCount() << " top-down + " << bfs.bottomUpLevelCount()
+                      << " bottom-up, Correct: " << (correct ? "Yes" : "No") << std::endl;
+            if (threads == defaultThreadCount()) break;
+        }
+
+        DepthFirstSearch dfs;
+        RoadGraph line = generateGridGraph(1000000, 1, 42);
+        start = std::chrono::high_resolution_clock::now();
+        dfs.run(line, 0);
+        end = std::chrono::high_resolution_clock::now();
+        std::cout << "  " << std::setw(16) << std::left << "DFS 10^6 path"
+                  << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " μs, "
+                  << "Depth: " << dfs.pathTo(static_cast<NodeId>(line.nodeCount() - 1)).size() << ", "
+                  << "Visited: " << dfs.visitedCount() << std::endl;
+    }
+
+    // Renumbering: start from a random node order (what arbitrary input
+    // order looks like at scale) and compare the locality orderings on the
+    // same Dijkstra workload and a full BFS
+    std::cout << "\nNode ordering (" << queries << " Dijkstra queries + full BFS, random input order):\n";
+    {
+        std::vector<NodeId> shuffle(graph.nodeCount());
+        for (NodeId node = 0; node < graph.nodeCount(); ++node) shuffle[node] = node;
+        std::shuffle(shuffle.begin(), shuffle.end(), std::mt19937(11));
+        RoadGraph shuffled = graph.renumbered(shuffle);
+
+        CacheMissCounter missCounter;
+        BreadthFirstSearch bfs;
+        double baselineMillis = 0.0;
+        for (NodeOrdering ordering : {NodeOrdering::Original, NodeOrdering::Hilbert, NodeOrdering::BreadthFirst,
+                                      NodeOrdering::ReverseCuthillMcKee}) {
+            auto start = std::chrono::high_resolution_clock::now();
+            std::vector<NodeId> newIds = computeNodeOrder(shuffled, ordering);
+            RoadGraph ordered = shuffled.renumbered(newIds);
+            auto end = std::chrono::high_resolution_clock::now();
+            double orderMillis = std::chrono::duration<double, std::milli>(end - start).count();
+
+            bool correct = true;
+            missCounter.start();
+            start = std::chrono::high_resolution_clock::now();
+            for (size_t i = 0; i < workload.size(); ++i) {
+                NodeId from = newIds[shuffle[workload[i].first]];
+                NodeId to = newIds[shuffle[workload[i].second]];
+                search.run(ordered, from, to, Metric::Distance);
+                correct = correct && !(std::abs(search.distanceTo(to) - reference[i]) > 1e-6);
+            }
+            bfs.run(ordered, newIds[shuffle[workload[0].first]]);
+            end = std::chrono::high_resolution_clock::now();
+            long long misses = missCounter.stop();
+            double millis = std::chrono::duration<double, std::milli>(end - start).count();
+            if (ordering == NodeOrdering::Original) baselineMillis = millis;
+
+            std::cout << "  " << std::setw(10) << std::left << nodeOrderingName(ordering) << std::right
+                      << std::fixed << std::setprecision(1)
+                      << "Order: " << std::setw(7) << orderMillis << " ms, "
+                      << "Queries: " << std::setw(7) << millis << " ms (" << std::setprecision(2)
+                      << baselineMillis / millis << "x), "
+                      << "Arc span: " << std::setprecision(0) << averageArcSpan(ordered) << ", "
+                      << "Cache misses: " << (misses < 0 ? std::string("n/a") : std::to_string(misses)) << ", "
+                      << "Correct: " << (correct ? "Yes" : "No") << std::endl;
+        }
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
+    }
+
+    // Snapping raw positions: nodes jittered by up to ~1 km, timed per query
+    // and checked against a linear scan on a sample
+    const size_t snapQueries = 100000;
+    std::cout << "\nSpatial index (" << snapQueries << " positions):\n";
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        SpatialIndex index = SpatialIndex::build(graph);
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << "  Build: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+                  << " ms\n";
+
+        std::uniform_real_distribution<> jitter(-0.01, 0.01);
+        std::vector<std::pair<double, double>> positions(snapQueries);
+        for (auto& position : positions) {
+            NodeId node = pick(gen);
+            position = {graph.latitude(node) + jitter(gen), graph.longitude(node) + jitter(gen)};
+        }
+
+        const size_t checked = std::min<size_t>(200, snapQueries);
+        const size_t k = 8;
+        const double radiusKm = 2.0;
+        bool nearestCorrect = true, nearestKCorrect = true, radiusCorrect = true;
+        std::vector<double> scan(graph.nodeCount());
+        for (size_t i = 0; i < checked; ++i) {
+            for (NodeId node = 0; node < graph.nodeCount(); ++node) {
+                scan[node] = greatCircleKm(positions[i].first, positions[i].second,
+                                           graph.latitude(node), graph.longitude(node));
+            }
+            std::vector<double> sorted = scan;
+            std::sort(sorted.begin(), sorted.end());
+
+            SpatialMatch match = index.nearest(positions[i].first, positions[i].second);
+            nearestCorrect = nearestCorrect && std::abs(match.distanceKm - sorted[0]) < 1e-6;
+
+            std::vector<SpatialMatch> matches = index.nearestK(positions[i].first, positions[i].second, k);
+            nearestKCorrect = nearestKCorrect && matches.size() == std::min(k, sorted.size());
+            for (size_t j = 0; nearestKCorrect && j < matches.size(); ++j) {
+                nearestKCorrect = std::abs(matches[j].distanceKm - sorted[j]) < 1e-6;
+            }
+
+            // Skip nodes within rounding of the boundary
+            size_t inside = 0, borderline = 0;
+            for (double km : sorted) {
+                if (km < radiusKm - 1e-6) ++inside;
+                else if (km <= radiusKm + 1e-6) ++borderline;
+            }
+            size_t found = index.withinRadius(positions[i].first, positions[i].second, radiusKm).size();
+            radiusCorrect = radiusCorrect && found >= inside && found <= inside + borderline;
+        }
+
+        auto timeQueries = [&](const std::string& name, bool correct, const std::function<size_t(size_t)>& query) {
+            size_t results = 0;
+            auto start = std::chrono::high_resolution_clock::now();
+            for (size_t i = 0; i < snapQueries; ++i) {
+                results += query(i);
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            double nanos = std::chrono::duration<double, std::nano>(end - start).count() / snapQueries;
+            std::cout << "  " << std::setw(16) << std::left << name << std::right << std::fixed
+                      << std::setprecision(0) << std::setw(7) << nanos << " ns per query, "
+                      << std::setprecision(1) << "Results: " << static_cast<double>(results) / snapQueries << ", "
+                      << "Correct: " << (correct ? "Yes" : "No") << std::endl;
+        };
+        timeQueries("Nearest", nearestCorrect, [&](size_t i) {
+            return index.nearest(positions[i].first, positions[i].second).node != INVALID_NODE ? 1 : 0;
+        });
+        timeQueries("Nearest 8", nearestKCorrect, [&](size_t i) {
+            return index.nearestK(positions[i].first, positions[i].second, k).size();
+        });
+        timeQueries("Radius 2 km", radiusCorrect, [&](size_t i) {
+            return index.withinRadius(positions[i].first, positions[i].second, radiusKm).size();
+        });
+
+        start = std::chrono::high_resolution_clock::now();
+        std::vector<SpatialMatch> snapped = index.snap(positions);
+        end = std::chrono::high_resolution_clock::now();
+        bool identical = true;
+        for (size_t i = 0; identical && i < checked; ++i) {
+            identical = snapped[i].node == index.nearest(positions[i].first, positions[i].second).node;
+        }
+        std::cout << "  " << std::setw(16) << std::left << ("Batch " + std::to_string(defaultThreadCount()) + "T")
+                  << std::right << std::setprecision(0) << std::setw(7)
+                  << std::chrono::duration<double, std::nano>(end - start).count() / snapQueries
+                  << " ns per query, Identical: " << (identical ? "Yes" : "No") << std::endl;
+
+        // Non-finite positions match nothing instead of crashing the search
+        bool rejected = true;
+        for (double bad : {std::nan(""), INFINITE_WEIGHT, -INFINITE_WEIGHT}) {
+            rejected = rejected && index.nearest(bad, 10.0).node == INVALID_NODE &&
+                       index.nearest(10.0, bad).node == INVALID_NODE &&
+                       index.nearestK(bad, 10.0, k).empty() && index.withinRadius(10.0, bad, radiusKm).empty();
+        }
+        std::cout << "  " << std::setw(16) << std::left << "Non-finite" << "Rejected: " << (rejected ? "Yes" : "No")
+                  << std::endl;
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
+    }
+
+    // Live traffic: reweight random roads by 0.5-2x in batches and repair a
+    // few cached time trees, against growing each tree again
+    std::cout << "\nDynamic updates (4 time trees, 5 rounds per batch size):\n";
+    {
+        RoadGraph live = graph;
+        std::vector<ShortestPathTree> trees;
+        for (size_t i = 0; i < 4; ++i) {
+            trees.push_back(ShortestPathTree::build(live, workload[i % workload.size()].first, Metric::Time));
+        }
+        std::uniform_real_distribution<> factor(0.5, 2.0);
+        for (size_t batch : {1, 10, 100, 1000}) {
+            double repairMicros = 0.0, rebuildMicros = 0.0;
+            size_t settled = 0;
+            bool correct = true;
+            for (int round = 0; round < 5; ++round) {
+                std::vector<WeightUpdate> updates;
+                std::vector<ArcChange> changes;
+                while (updates.size() < batch) {
+                    NodeId from = pick(gen);
+                    if (live.firstEdge(from) == live.endEdge(from)) continue;
+                    EdgeId e = live.firstEdge(from) + gen() % (live.endEdge(from) - live.firstEdge(from));
+                    NodeId to = live.target(e);
+                    updates.push_back({from, to, live.distance(e), live.time(e) * factor(gen)});
+                    changes.emplace_back(from, to);
+                    changes.emplace_back(to, from);
+                }
+
+                auto start = std::chrono::high_resolution_clock::now();
+                live.applyWeightUpdates(updates);
+                for (auto& tree : trees) {
+                    settled += tree.repair(live, changes);
+                }
+                auto end = std::chrono::high_resolution_clock::now();
+                repairMicros += std::chrono::duration<double, std::micro>(end - start).count();
+
+                for (const auto& tree : trees) {
+                    start = std::chrono::high_resolution_clock::now();
+                    ShortestPathTree fresh = ShortestPathTree::build(live, tree.source(), Metric::Time);
+                    end = std::chrono::high_resolution_clock::now();
+                    rebuildMicros += std::chrono::duration<double, std::micro>(end - start).count();
+                    for (NodeId node = 0; correct && node < live.nodeCount(); ++node) {
+                        correct = std::abs(fresh.distanceTo(node) - tree.distanceTo(node)) <= 1e-9 ||
+                                  fresh.distanceTo(node) == tree.distanceTo(node);
+                    }
+                }
+            }
+            std::cout << "  Batch " << std::setw(5) << std::left << batch << std::right << std::fixed
+                      << std::setprecision(0) << "Repair: " << std::setw(8) << repairMicros / 5 << " μs, "
+                      << "Rebuild: " << std::setw(8) << rebuildMicros / 5 << " μs, "
+                      << "Settled: " << settled / 5 << " of " << trees.size() * live.nodeCount() << ", "
+                      << "Correct: " << (correct ? "Yes" : "No") << std::endl;
+            std::cout.unsetf(std::ios::floatfield);
+            std::cout << std::setprecision(6);
+        }
+    }
+
+    std::cout << "\nGraph loading (" << graph.edgeCount() << " route lines):\n";
+    const std::string routesFile = "routes_bench.txt";
+    {
+        std::ofstream out(routesFile);
+        out.precision(10);
+        for (NodeId node = 0; node < graph.nodeCount(); ++node) {
+            for (EdgeId e = graph.firstEdge(node); e < graph.endEdge(node); ++e) {
+                out << "N" << node << " N" << graph.target(e) << " " << graph.distance(e) << " " << graph.time(e) << "\n";
+            }
+        }
+    }
+
+    std::vector<double> streamValues, mappedValues;
+    auto loadStart = std::chrono::high_resolution_clock::now();
+    {
+        std::ifstream in(routesFile);
+        std::string line, from, to;
+        double distance, time;
+        while (std::getline(in, line)) {
+            std::istringstream iss(line);
+            if (iss >> from >> to >> distance >> time) {
+                streamValues.push_back(distance);
+                streamValues.push_back(time);
+            }
+        }
+    }
+    auto loadEnd = std::chrono::high_resolution_clock::now();
+    std::cout << "  " << std::setw(16) << std::left << "getline+stream"
+              << std::chrono::duration_cast<std::chrono::milliseconds>(loadEnd - loadStart).count() << " ms\n";
+
+    loadStart = std::chrono::high_resolution_clock::now();
+    {
+        MappedFile in;
+        in.open(routesFile);
+        const char* cursor = in.data();
+        const char* end = cursor + in.size();
+        std::string_view tokens[4];
+        double distance, time;
+        while (cursor < end) {
+            if (nextLineTokens(cursor, end, tokens, 4) == 4 &&
+                parseDouble(tokens[2], distance) && parseDouble(tokens[3], time)) {
+                mappedValues.push_back(distance);
+                mappedValues.push_back(time);
+            }
+        }
+    }
+    loadEnd = std::chrono::high_resolution_clock::now();
+    std::cout << "  " << std::setw(16) << std::left << "mmap parser"
+              << std::chrono::duration_cast<std::chrono::milliseconds>(loadEnd - loadStart).count() << " ms, "
+              << "Identical: " << (mappedValues == streamValues ? "Yes" : "No") << std::endl;
+    std::remove(routesFile.c_str());
+
+    const std::string graphSnapshot = "graph_bench.bin";
+    graph.save(graphSnapshot);
+    RoadGraph reloaded;
+    loadStart = std::chrono::high_resolution_clock::now();
+    bool snapshotLoaded = reloaded.load(graphSnapshot);
+    loadEnd = std::chrono::high_resolution_clock::now();
+    std::remove(graphSnapshot.c_str());
+    bool snapshotCorrect = snapshotLoaded && reloaded.nodeCount() == graph.nodeCount() &&
+                           reloaded.edgeCount() == graph.edgeCount();
+    for (EdgeId e = 0; snapshotCorrect && e < graph.edgeCount(); ++e) {
+        snapshotCorrect = reloaded.target(e) == graph.target(e) && reloaded.distance(e) == graph.distance(e);
+    }
+    std::cout << "  " << std::setw(16) << std::left << "Snapshot load"
+              << std::chrono::duration_cast<std::chrono::microseconds>(loadEnd - loadStart).count() << " μs, "
+              << "Correct: " << (snapshotCorrect ? "Yes" : "No") << std::endl;
+
+    std::cout << "\nPeak resident memory: " << peakResidentKiB() / 1024 << " MiB" << std::endl;
+    std::cout << "\n=== Benchmark Complete ===" << std::endl;
+    return 0;
+}
@@ -2,10 +2,11 @@
 #include <iostream>
 #include <iomanip>
 #include <chrono>
+#include <sstream>
 
 int main() {
     std::cout << "=== DSA Pathfinding Algorithm Visualizer ===" << std::endl;
-    std::cout << "Indian Cities Network Analysis (Dijkstra, BFS, DFS)\n\n";
+    std::cout << "Indian Cities Network Analysis (Dijkstra, A*, BFS, DFS)\n\n";
     
     PathfindingVisualizer pathfinder;
     
@@ -30,14 +31,20 @@ int main() {
     for (const auto& route : testRoutes) {
         std::cout << "--- Route: " << route.first << " to " << route.second << " ---\n";
         
-        // Compare all three algorithms
+        // Compare all algorithms
         auto start = std::chrono::high_resolution_clock::now();
         auto results = pathfinder.compareAlgorithms(route.first, route.second);
         auto end = std::chrono::high_resolution_clock::now();
         
         auto totalTime = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
         
-        std::cout << "Total comparison time: " << totalTime.count() << " μs\n\n";
+        std::cout << "Total comparison time: " << totalTime.count() << " μs\n";
+        if constexpr (SEARCH_STATS_ENABLED) {
+            for (const auto& result : results) {
+                std::cout << "  " << result.algorithm << ": " << result.stats.totalMicros() << " μs\n";
+            }
+        }
+        std::cout << "\n";
         
         for (const auto& result : results) {
             pathfinder.printPath(result);
@@ -47,6 +54,35 @@ int main() {
         std::cout << "========================================\n\n";
     }
     
+    // Batched distance / travel-time matrix
+    std::cout << "Distance Matrix (km / hours):\n";
+    std::cout << "=============================\n";
+    std::vector<std::string> depots = {"Mumbai", "Delhi", "Bangalore"};
+    std::vector<std::string> destinations = {"Pune", "Jaipur", "Chennai", "Hyderabad"};
+    DistanceMatrix travelTimes;
+    DistanceMatrix distances = pathfinder.distanceMatrix(depots, destinations, Metric::Distance,
+                                                         defaultThreadCount(), &travelTimes);
+    std::cout << std::setw(12) << std::left << "";
+    for (const auto& destination : destinations) {
+        std::cout << std::setw(16) << std::left << destination;
+    }
+    std::cout << std::endl;
+    for (size_t i = 0; i < depots.size(); ++i) {
+        std::cout << std::setw(12) << std::left << depots[i];
+        for (size_t j = 0; j < destinations.size(); ++j) {
+            std::ostringstream cell;
+            if (distances.at(i, j) == INFINITE_WEIGHT) {
+                cell << "-";
+            } else {
+                cell << std::fixed << std::setprecision(0) << distances.at(i, j) << " / "
+                     << std::setprecision(1) << travelTimes.at(i, j);
+            }
+            std::cout << std::setw(16) << std::left << cell.str();
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::endl;
+    
     // Graph analysis
     std::cout << "Graph Analysis:\n";
     std::cout << "===============\n";
@@ -59,10 +95,11 @@ int main() {
     pathfinder.findConnectedComponents();
     std::cout << std::endl;
     
-    // Calculate average path length
-    std::cout << "Average Path Length Analysis:\n";
-    std::cout << "=============================\n";
-    pathfinder.calculateAveragePathLength();
+    // All-pairs path statistics
+    std::cout << "All-Pairs Path Analysis:\n";
+    std::cout << "========================\n";
+    pathfinder.analyzeAllPairs();
+    std::cout << std::endl;
     
     // Export results
     std::cout << "Exporting results to 'pathfinding_results.txt'...\n";
@@ -70,6 +107,41 @@ int main() {
     pathfinder.exportResults(allResults, "pathfinding_results.txt");
     std::cout << "Results exported successfully!\n\n";
     
+    // Repeated test routes are answered from the query cache
+    for (const auto& route : testRoutes) {
+        pathfinder.compareAlgorithms(route.first, route.second);
+    }
+    QueryCacheStats cacheStats = pathfinder.getQueryCacheStats();
+    std::cout << "Query cache: " << cacheStats.resultHits << " hits, " << cacheStats.resultMisses << " misses, "
+              << cacheStats.resultEntries << " entries; source trees: " << cacheStats.treeEntries << "\n\n";
+    
+    // Live update: Mumbai is a hot origin by now, so its cached tree is
+    // repaired in place when the direct Chennai road gets a long detour
+    for (const char* city : {"Delhi", "Surat", "Nagpur"}) {
+        pathfinder.dijkstra("Mumbai", city);
+    }
+    std::cout << "Road update: Mumbai - Chennai detour, now 1400 km\n";
+    size_t repaired = pathfinder.updateRoutes({Route("Mumbai", "Chennai", 1400.0, 2.4)});
+    std::cout << "Cached trees repaired (" << repaired << " nodes settled)\n";
+    pathfinder.printPath(pathfinder.dijkstra("Mumbai", "Chennai"));
+    std::cout << std::endl;
+    
+    // Raw positions snap to the nearest city before routing
+    std::cout << "Route from GPS (19.10, 72.90) to (13.00, 77.60)\n";
+    std::cout << "Snapped to " << pathfinder.nearestCity(19.10, 72.90) << " and "
+              << pathfinder.nearestCity(13.00, 77.60) << "\n";
+    pathfinder.printPath(pathfinder.routeBetweenCoordinates(19.10, 72.90, 13.00, 77.60));
+    std::cout << std::endl;
+    
+    // Latency and work histograms for everything above
+    if constexpr (SEARCH_STATS_ENABLED) {
+        std::cout << "Exporting query statistics to 'query_stats.json'...\n";
+        if (pathfinder.exportQueryStats("query_stats.json")) {
+            std::cout << "Dijkstra latency p50 / p99: " << pathfinder.getQueryStats().latencyPercentile("Dijkstra", 0.5)
+                      << " / " << pathfinder.getQueryStats().latencyPercentile("Dijkstra", 0.99) << " μs\n\n";
+        }
+    }
+    
     // Interactive testing
     std::cout << "Interactive Testing:\n";
     std::cout << "====================\n";
@@ -0,0 +1,324 @@
+#ifndef PRIORITY_QUEUES_H
+#define PRIORITY_QUEUES_H
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+
+/**
+ * Priority Queues for Shortest Path Search
+ * All queues share the same interface so the search loop can be templated on them:
+ *   push(node, key)  - insert, or lower the key of a node already queued
+ *   pop()            - remove and return the entry with the smallest key
+ *   empty(), size(), clear(), reserve(nodeCount)
+ * Lazy queues may hand back stale entries; callers skip entries whose key
+ * is larger than the node's current tentative distance.
+ */
+
+template <typename Key>
+struct HeapEntry {
+    Key key;
+    uint32_t node;
+
+    HeapEntry() : key(), node(0) {}
+    HeapEntry(Key k, uint32_t n) : key(k), node(n) {}
+};
+
+// Binary heap with lazy deletion - decrease-key pushes a duplicate entry
+template <typename Key>
+class LazyBinaryHeap {
+private:
+    std::vector<HeapEntry<Key>> heap;
+
+public:
+    void reserve(size_t nodeCount) { heap.reserve(nodeCount); }
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    void clear() { heap.clear(); }
+    const HeapEntry<Key>& top() const { return heap[0]; }
+
+    void push(uint32_t node, Key key) {
+        heap.emplace_back(key, node);
+        size_t i = heap.size() - 1;
+        HeapEntry<Key> entry = heap[i];
+        while (i > 0) {
+            size_t parent = (i - 1) / 2;
+            if (!(entry.key < heap[parent].key)) break;
+            heap[i] = heap[parent];
+            i = parent;
+        }
+        heap[i] = entry;
+    }
+
+    HeapEntry<Key> pop() {
+        HeapEntry<Key> top = heap[0];
+        HeapEntry<Key> last = heap.back();
+        heap.pop_back();
+        size_t n = heap.size();
+        if (n > 0) {
+            size_t i = 0;
+            while (true) {
+                size_t child = 2 * i + 1;
+                if (child >= n) break;
+                if (child + 1 < n && heap[child + 1].key < heap[child].key) child++;
+                if (!(heap[child].key < last.key)) break;
+                heap[i] = heap[child];
+                i = child;
+            }
+            heap[i] = last;
+        }
+        return top;
+    }
+};
+
+// Indexed d-ary heap (default 4-ary) with true decrease-key, one slot per node
+template <typename Key, unsigned Arity = 4>
+class IndexedDaryHeap {
+private:
+    static constexpr uint32_t NOT_IN_HEAP = std::numeric_limits<uint32_t>::max();
+
+    std::vector<HeapEntry<Key>> heap;
+    std::vector<uint32_t> position; // node -> slot in heap
+
+    void place(size_t slot, const HeapEntry<Key>& entry) {
+        heap[slot] = entry;
+        position[entry.node] = static_cast<uint32_t>(slot);
+    }
+
+    void siftUp(size_t i, HeapEntry<Key> entry) {
+        while (i > 0) {
+            size_t parent = (i - 1) / Arity;
+            if (!(entry.key < heap[parent].key)) break;
+            place(i, heap[parent]);
+            i = parent;
+        }
+        place(i, entry);
+    }
+
+    void siftDown(size_t i, HeapEntry<Key> entry) {
+        size_t n = heap.size();
+        while (true) {
+            size_t first = Arity * i + 1;
+            if (first >= n) break;
+            size_t last = std::min(first + Arity, n);
+            size_t best = first;
+            for (size_t c = first + 1; c < last; ++c) {
+                if (heap[c].key < heap[best].key) best = c;
+            }
+            if (!(heap[best].key < entry.key)) break;
+            place(i, heap[best]);
+            i = best;
+        }
+        place(i, entry);
+    }
+
+public:
+    void reserve(size_t nodeCount) {
+        if (position.size() < nodeCount) position.resize(nodeCount, NOT_IN_HEAP);
+        heap.reserve(nodeCount);
+    }
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    bool contains(uint32_t node) const { return node < position.size() && position[node] != NOT_IN_HEAP; }
+    const HeapEntry<Key>& top() const { return heap[0]; }
+
+    void clear() {
+        for (const auto& entry : heap) position[entry.node] = NOT_IN_HEAP;
+        heap.clear();
+    }
+
+    void push(uint32_t node, Key key) {
+        if (node >= position.size()) position.resize(node + 1, NOT_IN_HEAP);
+        if (position[node] == NOT_IN_HEAP) {
+            heap.emplace_back();
+            siftUp(heap.size() - 1, HeapEntry<Key>(key, node));
+        } else if (key < heap[position[node]].key) {
+            siftUp(position[node], HeapEntry<Key>(key, node));
+        }
+    }
+
+    HeapEntry<Key> pop() {
+        HeapEntry<Key> top = heap[0];
+        position[top.node] = NOT_IN_HEAP;
+        HeapEntry<Key> last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) siftDown(0, last);
+        return top;
+    }
+};
+
+// Pairing heap over a node-indexed pool, decrease-key by cut and meld
+template <typename Key>
+class PairingHeap {
+private:
+    static constexpr uint32_t NIL = std::numeric_limits<uint32_t>::max();
+
+    struct Node {
+        Key key;
+        uint32_t child;
+        uint32_t sibling;
+        uint32_t prev;   // parent if first child, else left sibling
+        bool queued;
+
+        Node() : key(), child(NIL), sibling(NIL), prev(NIL), queued(false) {}
+    };
+
+    std::vector<Node> pool;
+    std::vector<uint32_t> touched;
+    std::vector<uint32_t> pairs; // scratch for two-pass merge
+    uint32_t root = NIL;
+    size_t count = 0;
+
+    uint32_t meld(uint32_t a, uint32_t b) {
+        if (a == NIL) return b;
+        if (b == NIL) return a;
+        if (pool[b].key < pool[a].key) std::swap(a, b);
+        // b becomes first child of a
+        pool[b].sibling = pool[a].child;
+        if (pool[a].child != NIL) pool[pool[a].child].prev = b;
+        pool[b].prev = a;
+        pool[a].child = b;
+        return a;
+    }
+
+    void cut(uint32_t x) {
+        uint32_t p = pool[x].prev;
+        if (pool[p].child == x) {
+            pool[p].child = pool[x].sibling;
+        } else {
+            pool[p].sibling = pool[x].sibling;
+        }
+        if (pool[x].sibling != NIL) pool[pool[x].sibling].prev = p;
+        pool[x].sibling = NIL;
+        pool[x].prev = NIL;
+    }
+
+public:
+    void reserve(size_t nodeCount) {
+        if (pool.size() < nodeCount) pool.resize(nodeCount);
+    }
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+
+    void clear() {
+        for (uint32_t node : touched) pool[node] = Node();
+        touched.clear();
+        root = NIL;
+        count = 0;
+    }
+
+    void push(uint32_t node, Key key) {
+        if (node >= pool.size()) pool.resize(node + 1);
+        Node& n = pool[node];
+        if (!n.queued) {
+            n = Node();
+            n.key = key;
+            n.queued = true;
+            touched.push_back(node);
+            root = meld(root, node);
+            count++;
+        } else if (key < n.key) {
+            n.key = key;
+            if (node != root) {
+                cut(node);
+                root = meld(root, node);
+            }
+        }
+    }
+
+    HeapEntry<Key> pop() {
+        uint32_t top = root;
+        HeapEntry<Key> result(pool[top].key, top);
+        pool[top].queued = false;
+        count--;
+
+        // Two-pass merge of the root's children
+        pairs.clear();
+        uint32_t c = pool[top].child;
+        while (c != NIL) {
+            uint32_t a = c;
+            uint32_t b = pool[a].sibling;
+            c = (b != NIL) ? pool[b].sibling : NIL;
+            pool[a].sibling = pool[a].prev = NIL;
+            if (b != NIL) pool[b].sibling = pool[b].prev = NIL;
+            pairs.push_back(meld(a, b));
+        }
+        uint32_t merged = NIL;
+        for (size_t i = pairs.size(); i-- > 0;) {
+            merged = meld(pairs[i], merged);
+        }
+        pool[top].child = NIL;
+        root = merged;
+        if (root != NIL) pool[root].prev = NIL;
+        return result;
+    }
+};
+
+// Radix heap for monotone integer keys (the popped minimum never decreases).
+// Non-negative doubles are accepted too: their IEEE-754 bit patterns order the
+// same way as the values, so they are bucketed on the raw bits.
+template <typename Key>
+class RadixHeap {
+private:
+    static constexpr int BUCKETS = 65;
+
+    std::vector<HeapEntry<Key>> buckets[BUCKETS];
+    uint64_t lastKey = 0;
+    size_t count = 0;
+
+    static uint64_t radixKey(Key key) {
+        if (std::is_floating_point<Key>::value) {
+            double value = static_cast<double>(key) + 0.0; // fold -0.0 into +0.0
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+        return static_cast<uint64_t>(key);
+    }
+
+    int bucketFor(uint64_t key) const {
+        return key == lastKey ? 0 : 64 - __builtin_clzll(key ^ lastKey);
+    }
+
+public:
+    void reserve(size_t) {}
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+
+    void clear() {
+        for (auto& bucket : buckets) bucket.clear();
+        lastKey = 0;
+        count = 0;
+    }
+
+    void push(uint32_t node, Key key) {
+        buckets[bucketFor(radixKey(key))].emplace_back(key, node);
+        count++;
+    }
+
+    HeapEntry<Key> pop() {
+        if (buckets[0].empty()) {
+            int i = 1;
+            while (buckets[i].empty()) i++;
+            // Smallest key in the first non-empty bucket becomes the new base
+            uint64_t minKey = std::numeric_limits<uint64_t>::max();
+            for (const auto& entry : buckets[i]) {
+                minKey = std::min(minKey, radixKey(entry.key));
+            }
+            lastKey = minKey;
+            for (const auto& entry : buckets[i]) {
+                buckets[bucketFor(radixKey(entry.key))].push_back(entry);
+            }
+            buckets[i].clear();
+        }
+        HeapEntry<Key> top = buckets[0].back();
+        buckets[0].pop_back();
+        count--;
+        return top;
+    }
+};
+
+#endif // PRIORITY_QUEUES_H
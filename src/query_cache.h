@@ -0,0 +1,180 @@
+#ifndef QUERY_CACHE_H
+#define QUERY_CACHE_H
+
+#include "road_graph.h"
+#include "shortest_path_tree.h"
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+
+/**
+ * Sharded LRU Cache
+ * Fixed-capacity least-recently-used cache split into independently locked
+ * shards, so concurrent lookups of different keys rarely contend. Every entry
+ * carries the graph version it was computed against; a lookup with a newer
+ * version treats the entry as a miss and drops it, which makes invalidation
+ * a single counter increment on the owner's side.
+ */
+
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class ShardedLruCache {
+private:
+    struct Entry {
+        Key key;
+        uint64_t version;
+        Value value;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::list<Entry> order; // most recently used first
+        std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> index;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    size_t shardCapacity;
+    Hash hasher;
+    std::atomic<size_t> hits;
+    std::atomic<size_t> misses;
+
+    Shard& shardFor(const Key& key) {
+        size_t h = hasher(key);
+        return *shards[(h ^ (h >> 17)) % shards.size()];
+    }
+
+public:
+    explicit ShardedLruCache(size_t capacity = 1024, size_t shardCount = 8)
+        : shardCapacity(std::max<size_t>(1, (capacity + shardCount - 1) / std::max<size_t>(1, shardCount))),
+          hits(0), misses(0) {
+        for (size_t i = 0; i < std::max<size_t>(1, shardCount); ++i) {
+            shards.push_back(std::make_unique<Shard>());
+        }
+    }
+
+    // Copies the cached value into `value`; false on a miss or a stale entry
+    bool get(const Key& key, uint64_t version, Value& value) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it == shard.index.end()) {
+            misses++;
+            return false;
+        }
+        if (it->second->version != version) {
+            shard.order.erase(it->second);
+            shard.index.erase(it);
+            misses++;
+            return false;
+        }
+        shard.order.splice(shard.order.begin(), shard.order, it->second);
+        value = it->second->value;
+        hits++;
+        return true;
+    }
+
+    void put(const Key& key, uint64_t version, Value value) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            it->second->version = version;
+            it->second->value = std::move(value);
+            shard.order.splice(shard.order.begin(), shard.order, it->second);
+            return;
+        }
+        if (shard.order.size() >= shardCapacity) {
+            shard.index.erase(shard.order.back().key);
+            shard.order.pop_back();
+        }
+        shard.order.push_front(Entry{key, version, std::move(value)});
+        shard.index.emplace(key, shard.order.begin());
+    }
+
+    // Carries entries tagged `fromVersion` over to `toVersion` after passing
+    // each through update(key, value), which may rewrite the value in place
+    // and returns false to drop it; entries from older versions are dropped.
+    template <typename Update>
+    void refresh(uint64_t fromVersion, uint64_t toVersion, Update update) {
+        for (auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            for (auto it = shard->order.begin(); it != shard->order.end();) {
+                if (it->version == fromVersion && update(it->key, it->value)) {
+                    it->version = toVersion;
+                    ++it;
+                } else {
+                    shard->index.erase(it->key);
+                    it = shard->order.erase(it);
+                }
+            }
+        }
+    }
+
+    void clear() {
+        for (auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->order.clear();
+            shard->index.clear();
+        }
+    }
+
+    size_t size() {
+        size_t total = 0;
+        for (auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            total += shard->order.size();
+        }
+        return total;
+    }
+
+    size_t hitCount() const { return hits; }
+    size_t missCount() const { return misses; }
+    void resetCounters() { hits = 0; misses = 0; }
+};
+
+// Point-to-point query identity: city names, metric, algorithm label and the
+// algorithm's own setting (queue type, heuristic mode, thread count), which
+// changes the work counters stored with the result
+struct QueryKey {
+    std::string source;
+    std::string destination;
+    Metric metric;
+    std::string algorithm;
+    uint32_t variant;
+
+    bool operator==(const QueryKey& other) const {
+        return source == other.source && destination == other.destination &&
+               metric == other.metric && algorithm == other.algorithm && variant == other.variant;
+    }
+};
+
+struct QueryKeyHash {
+    size_t operator()(const QueryKey& key) const {
+        std::hash<std::string> hashString;
+        size_t h = hashString(key.source);
+        h = h * 31 + hashString(key.destination);
+        h = h * 31 + static_cast<size_t>(key.metric);
+        h = h * 31 + hashString(key.algorithm);
+        return h * 31 + key.variant;
+    }
+};
+
+struct TreeKey {
+    NodeId source;
+    Metric metric;
+
+    bool operator==(const TreeKey& other) const { return source == other.source && metric == other.metric; }
+};
+
+struct TreeKeyHash {
+    size_t operator()(const TreeKey& key) const {
+        return std::hash<uint64_t>()((static_cast<uint64_t>(key.source) << 1) | static_cast<uint64_t>(key.metric));
+    }
+};
+
+#endif // QUERY_CACHE_H
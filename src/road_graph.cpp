@@ -0,0 +1,294 @@
+#include "road_graph.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+const char GRAPH_MAGIC[4] = {'S', 'V', 'R', 'G'};
+const uint32_t GRAPH_FORMAT_VERSION = 1;
+
+template <typename T>
+void writeVector(std::ofstream& file, const std::vector<T>& values) {
+    uint64_t size = values.size();
+    file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    file.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(size * sizeof(T)));
+}
+
+// Per-node attribute moved to the node's new position; empty stays empty
+template <typename T>
+std::vector<T> permuteNodes(const std::vector<T>& values, const std::vector<NodeId>& newIds) {
+    std::vector<T> moved(values.size());
+    for (size_t node = 0; node < values.size(); ++node) {
+        moved[newIds[node]] = values[node];
+    }
+    return moved;
+}
+
+// CSR offsets for n nodes over m arcs: starts at 0, never decreases, ends at m
+bool validOffsets(const std::vector<EdgeId>& offsets, size_t n, size_t m) {
+    if (offsets.size() != n + 1 || offsets.front() != 0 || offsets.back() != m) {
+        return false;
+    }
+    return std::is_sorted(offsets.begin(), offsets.end());
+}
+
+} // namespace
+
+RoadGraph RoadGraph::fromEdges(size_t nodeCount, const std::vector<RoadEdge>& edges, bool undirected) {
+    std::vector<RoadEdge> arcs;
+    arcs.reserve(undirected ? edges.size() * 2 : edges.size());
+    for (const auto& edge : edges) {
+        arcs.push_back(edge);
+        if (undirected) {
+            arcs.emplace_back(edge.to, edge.from, edge.distance, edge.time);
+        }
+    }
+
+    // Stable sort keeps input order among parallel edges, so the last one wins below
+    std::stable_sort(arcs.begin(), arcs.end(), [](const RoadEdge& a, const RoadEdge& b) {
+        return a.from != b.from ? a.from < b.from : a.to < b.to;
+    });
+
+    RoadGraph graph;
+    graph.offsets.assign(nodeCount + 1, 0);
+    graph.targets.reserve(arcs.size());
+    graph.distances.reserve(arcs.size());
+    graph.times.reserve(arcs.size());
+
+    for (size_t i = 0; i < arcs.size(); ++i) {
+        if (i + 1 < arcs.size() && arcs[i + 1].from == arcs[i].from && arcs[i + 1].to == arcs[i].to) {
+            continue;
+        }
+        graph.offsets[arcs[i].from + 1]++;
+        graph.targets.push_back(arcs[i].to);
+        graph.distances.push_back(arcs[i].distance);
+        graph.times.push_back(arcs[i].time);
+    }
+
+    for (size_t node = 0; node < nodeCount; ++node) {
+        graph.offsets[node + 1] += graph.offsets[node];
+    }
+
+    graph.directed = !undirected;
+    if (graph.directed) {
+        graph.buildReverseArcs();
+    }
+
+    return graph;
+}
+
+// Counting sort of the forward arcs by target
+void RoadGraph::buildReverseArcs() {
+    size_t n = nodeCount();
+    reverseOffsets.assign(n + 1, 0);
+    for (NodeId target : targets) {
+        reverseOffsets[target + 1]++;
+    }
+    for (size_t node = 0; node < n; ++node) {
+        reverseOffsets[node + 1] += reverseOffsets[node];
+    }
+
+    std::vector<EdgeId> next(reverseOffsets.begin(), reverseOffsets.end() - 1);
+    reverseSources.resize(targets.size());
+    reverseEdgeIds.resize(targets.size());
+    for (NodeId node = 0; node < n; ++node) {
+        for (EdgeId edge = offsets[node]; edge < offsets[node + 1]; ++edge) {
+            EdgeId slot = next[targets[edge]]++;
+            reverseSources[slot] = node;
+            reverseEdgeIds[slot] = edge;
+        }
+    }
+}
+
+RoadGraph RoadGraph::renumbered(const std::vector<NodeId>& newIds) const {
+    size_t n = nodeCount();
+    std::vector<NodeId> oldIds(n);
+    for (NodeId node = 0; node < n; ++node) {
+        oldIds[newIds[node]] = node;
+    }
+
+    RoadGraph graph;
+    graph.directed = directed;
+    graph.offsets.assign(n + 1, 0);
+    graph.targets.resize(targets.size());
+    graph.distances.resize(targets.size());
+    graph.times.resize(targets.size());
+
+    // Arcs of each node in its new position, targets re-sorted by new id
+    std::vector<std::pair<NodeId, EdgeId>> arcs;
+    for (NodeId node = 0; node < n; ++node) {
+        NodeId old = oldIds[node];
+        arcs.clear();
+        for (EdgeId e = offsets[old]; e < offsets[old + 1]; ++e) {
+            arcs.emplace_back(newIds[targets[e]], e);
+        }
+        std::sort(arcs.begin(), arcs.end());
+        EdgeId slot = graph.offsets[node];
+        for (const auto& arc : arcs) {
+            graph.targets[slot] = arc.first;
+            graph.distances[slot] = distances[arc.second];
+            graph.times[slot] = times[arc.second];
+            slot++;
+        }
+        graph.offsets[node + 1] = slot;
+    }
+    if (directed) {
+        graph.buildReverseArcs();
+    }
+
+    graph.names = permuteNodes(names, newIds);
+    graph.latitudes = permuteNodes(latitudes, newIds);
+    graph.longitudes = permuteNodes(longitudes, newIds);
+    return graph;
+}
+
+EdgeId RoadGraph::reverseEdge(EdgeId arc) const {
+    if (directed) {
+        return reverseEdgeIds[arc];
+    }
+    // In an undirected graph the arc is node -> source; find its mirror source -> node
+    NodeId node = static_cast<NodeId>(std::upper_bound(offsets.begin(), offsets.end(), arc) - offsets.begin() - 1);
+    return findEdge(targets[arc], node);
+}
+
+EdgeId RoadGraph::findEdge(NodeId from, NodeId to) const {
+    auto begin = targets.begin() + offsets[from];
+    auto end = targets.begin() + offsets[from + 1];
+    auto it = std::lower_bound(begin, end, to);
+    if (it == end || *it != to) {
+        return INVALID_EDGE;
+    }
+    return static_cast<EdgeId>(it - targets.begin());
+}
+
+size_t RoadGraph::applyWeightUpdates(const std::vector<WeightUpdate>& updates) {
+    size_t applied = 0;
+    for (const auto& update : updates) {
+        if (update.from >= nodeCount() || update.to >= nodeCount()) {
+            continue;
+        }
+        EdgeId edge = findEdge(update.from, update.to);
+        if (edge == INVALID_EDGE) {
+            continue;
+        }
+        distances[edge] = update.distance;
+        times[edge] = update.time;
+        if (!directed) {
+            EdgeId mirror = findEdge(update.to, update.from);
+            distances[mirror] = update.distance;
+            times[mirror] = update.time;
+        }
+        applied++;
+    }
+    return applied;
+}
+
+void RoadGraph::setNodeInfo(std::vector<std::string> nodeNames, std::vector<double> nodeLatitudes,
+                            std::vector<double> nodeLongitudes) {
+    names = std::move(nodeNames);
+    latitudes = std::move(nodeLatitudes);
+    longitudes = std::move(nodeLongitudes);
+}
+
+bool RoadGraph::save(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error opening graph file: " << filename << std::endl;
+        return false;
+    }
+
+    // Names are stored as one character block plus end offsets
+    std::vector<uint64_t> nameEnds;
+    std::vector<char> nameChars;
+    for (const auto& name : names) {
+        nameChars.insert(nameChars.end(), name.begin(), name.end());
+        nameEnds.push_back(nameChars.size());
+    }
+
+    uint8_t directedTag = directed ? 1 : 0;
+    file.write(GRAPH_MAGIC, sizeof(GRAPH_MAGIC));
+    file.write(reinterpret_cast<const char*>(&GRAPH_FORMAT_VERSION), sizeof(GRAPH_FORMAT_VERSION));
+    file.write(reinterpret_cast<const char*>(&directedTag), sizeof(directedTag));
+    writeVector(file, offsets);
+    writeVector(file, targets);
+    writeVector(file, distances);
+    writeVector(file, times);
+    writeVector(file, reverseOffsets);
+    writeVector(file, reverseSources);
+    writeVector(file, reverseEdgeIds);
+    writeVector(file, latitudes);
+    writeVector(file, longitudes);
+    writeVector(file, nameEnds);
+    writeVector(file, nameChars);
+    return static_cast<bool>(file);
+}
+
+bool RoadGraph::load(const std::string& filename) {
+    MappedFile file;
+    if (!file.open(filename)) {
+        return false;
+    }
+
+    MappedReader reader(file.data(), file.size());
+    char magic[4];
+    uint32_t version = 0;
+    uint8_t directedTag = 0;
+    if (!reader.read(magic) || !reader.read(version) || !reader.read(directedTag) ||
+        std::memcmp(magic, GRAPH_MAGIC, sizeof(magic)) != 0 || version != GRAPH_FORMAT_VERSION) {
+        std::cerr << "Unsupported graph file: " << filename << std::endl;
+        return false;
+    }
+
+    RoadGraph loaded;
+    loaded.directed = directedTag != 0;
+    std::vector<uint64_t> nameEnds;
+    std::vector<char> nameChars;
+    bool ok = reader.readVector(loaded.offsets) && reader.readVector(loaded.targets) &&
+              reader.readVector(loaded.distances) && reader.readVector(loaded.times) &&
+              reader.readVector(loaded.reverseOffsets) && reader.readVector(loaded.reverseSources) &&
+              reader.readVector(loaded.reverseEdgeIds) && reader.readVector(loaded.latitudes) &&
+              reader.readVector(loaded.longitudes) && reader.readVector(nameEnds) && reader.readVector(nameChars);
+
+    size_t n = loaded.offsets.empty() ? 0 : loaded.offsets.size() - 1;
+    size_t m = loaded.targets.size();
+    ok = ok && validOffsets(loaded.offsets, n, m) &&
+         loaded.distances.size() == m && loaded.times.size() == m &&
+         (loaded.latitudes.empty() || (loaded.latitudes.size() == n && loaded.longitudes.size() == n)) &&
+         (nameEnds.empty() || nameEnds.size() == n) &&
+         (!loaded.directed || (validOffsets(loaded.reverseOffsets, n, m) && loaded.reverseSources.size() == m &&
+                               loaded.reverseEdgeIds.size() == m));
+    for (size_t e = 0; ok && e < m; ++e) {
+        ok = loaded.targets[e] < n;
+    }
+    // The reverse arrays are only read for directed graphs
+    for (size_t r = 0; ok && loaded.directed && r < m; ++r) {
+        ok = loaded.reverseSources[r] < n && loaded.reverseEdgeIds[r] < m;
+    }
+    for (size_t i = 0; ok && i < nameEnds.size(); ++i) {
+        uint64_t begin = i == 0 ? 0 : nameEnds[i - 1];
+        ok = begin <= nameEnds[i] && nameEnds[i] <= nameChars.size();
+        if (ok) loaded.names.emplace_back(nameChars.data() + begin, nameEnds[i] - begin);
+    }
+    if (!ok) {
+        std::cerr << "Corrupt graph file: " << filename << std::endl;
+        return false;
+    }
+
+    *this = std::move(loaded);
+    return true;
+}
+
+size_t RoadGraph::memoryUsage() const {
+    size_t bytes = offsets.capacity() * sizeof(EdgeId)
+                 + targets.capacity() * sizeof(NodeId)
+                 + (distances.capacity() + times.capacity()) * sizeof(double)
+                 + (reverseOffsets.capacity() + reverseEdgeIds.capacity()) * sizeof(EdgeId)
+                 + reverseSources.capacity() * sizeof(NodeId)
+                 + (latitudes.capacity() + longitudes.capacity()) * sizeof(double);
+    for (const auto& name : names) {
+        bytes += sizeof(std::string) + name.capacity();
+    }
+    return bytes;
+}
@@ -0,0 +1,127 @@
+#ifndef ROAD_GRAPH_H
+#define ROAD_GRAPH_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <limits>
+
+/**
+ * Compact Road Graph
+ * Compressed sparse row (CSR) adjacency over integer node IDs, used by the
+ * performance-oriented search engines instead of the string-keyed maps
+ */
+
+using NodeId = uint32_t;
+using EdgeId = uint32_t;
+
+const NodeId INVALID_NODE = std::numeric_limits<NodeId>::max();
+const EdgeId INVALID_EDGE = std::numeric_limits<EdgeId>::max();
+const double INFINITE_WEIGHT = std::numeric_limits<double>::infinity();
+
+enum class Metric {
+    Distance, // kilometers
+    Time      // hours
+};
+
+struct RoadEdge {
+    NodeId from;
+    NodeId to;
+    double distance;
+    double time;
+
+    RoadEdge() : from(INVALID_NODE), to(INVALID_NODE), distance(0.0), time(0.0) {}
+    RoadEdge(NodeId f, NodeId t, double dist, double t_time)
+        : from(f), to(t), distance(dist), time(t_time) {}
+};
+
+// New weights for an existing arc (live traffic, closures priced as a large time)
+struct WeightUpdate {
+    NodeId from;
+    NodeId to;
+    double distance;
+    double time;
+};
+
+class RoadGraph {
+private:
+    std::vector<EdgeId> offsets;   // size nodeCount + 1
+    std::vector<NodeId> targets;
+    std::vector<double> distances;
+    std::vector<double> times;
+
+    // Incoming arcs, only stored for directed graphs (undirected ones reuse the forward arrays)
+    bool directed;
+    std::vector<EdgeId> reverseOffsets;
+    std::vector<NodeId> reverseSources;
+    std::vector<EdgeId> reverseEdgeIds; // forward edge id of each incoming arc
+
+    std::vector<std::string> names;
+    std::vector<double> latitudes;
+    std::vector<double> longitudes;
+
+    void buildReverseArcs();
+
+public:
+    RoadGraph() : offsets(1, 0), directed(false) {}
+
+    // Build from an edge list. Undirected graphs mirror every edge; when the
+    // same (from, to) pair appears more than once the last occurrence wins.
+    static RoadGraph fromEdges(size_t nodeCount, const std::vector<RoadEdge>& edges, bool undirected);
+
+    // Same graph with node `v` moved to newIds[v] (a permutation of
+    // 0..nodeCount-1). Arcs, weights, names and coordinates move along, so
+    // name(newIds[v]) is still v's name.
+    RoadGraph renumbered(const std::vector<NodeId>& newIds) const;
+
+    size_t nodeCount() const { return offsets.size() - 1; }
+    size_t edgeCount() const { return targets.size(); }
+
+    EdgeId firstEdge(NodeId node) const { return offsets[node]; }
+    EdgeId endEdge(NodeId node) const { return offsets[node + 1]; }
+    NodeId target(EdgeId edge) const { return targets[edge]; }
+    double distance(EdgeId edge) const { return distances[edge]; }
+    double time(EdgeId edge) const { return times[edge]; }
+    double weight(EdgeId edge, Metric metric) const {
+        return metric == Metric::Distance ? distances[edge] : times[edge];
+    }
+
+    // Incoming arcs of a node: reverseSource(r) -> node has forward edge id reverseEdge(r)
+    bool isDirected() const { return directed; }
+    EdgeId firstReverseEdge(NodeId node) const { return directed ? reverseOffsets[node] : offsets[node]; }
+    EdgeId endReverseEdge(NodeId node) const { return directed ? reverseOffsets[node + 1] : offsets[node + 1]; }
+    NodeId reverseSource(EdgeId arc) const { return directed ? reverseSources[arc] : targets[arc]; }
+    EdgeId reverseEdge(EdgeId arc) const;
+    double reverseWeight(EdgeId arc, Metric metric) const {
+        EdgeId edge = directed ? reverseEdgeIds[arc] : arc; // mirrored arcs carry the same weights
+        return metric == Metric::Distance ? distances[edge] : times[edge];
+    }
+
+    // Edge from -> to, or INVALID_EDGE (targets are sorted per node)
+    EdgeId findEdge(NodeId from, NodeId to) const;
+
+    // Rewrites weights in place without touching the CSR structure; undirected
+    // graphs update both directions of the road. Updates for arcs that do not
+    // exist are skipped (inserting arcs needs fromEdges). Returns the number of
+    // updates applied.
+    size_t applyWeightUpdates(const std::vector<WeightUpdate>& updates);
+
+    // Node attributes
+    void setNodeInfo(std::vector<std::string> nodeNames, std::vector<double> nodeLatitudes,
+                     std::vector<double> nodeLongitudes);
+    bool hasNames() const { return !names.empty(); }
+    bool hasCoordinates() const { return !latitudes.empty(); }
+    const std::string& name(NodeId node) const { return names[node]; }
+    double latitude(NodeId node) const { return latitudes[node]; }
+    double longitude(NodeId node) const { return longitudes[node]; }
+
+    // Versioned binary snapshot of the CSR arrays, coordinates and names.
+    // load() maps the file and copies each array out in one block, so there
+    // is nothing to parse; false on I/O error or format mismatch.
+    bool save(const std::string& filename) const;
+    bool load(const std::string& filename);
+
+    size_t memoryUsage() const;
+};
+
+#endif // ROAD_GRAPH_H
@@ -0,0 +1,509 @@
+#include "routing_daemon.h"
+#include "distance_matrix.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// epoll user data for the two non-connection descriptors; connection ids start above
+const uint64_t LISTEN_ID = 0;
+const uint64_t WAKE_ID = 1;
+
+const size_t READ_CHUNK = 64 * 1024;
+const size_t MAX_MATRIX_CELLS = 1u << 20;
+// Smallest NodeRef on the wire: the kind byte and an empty name's uint16 length
+const size_t MIN_NODE_REF_SIZE = 3;
+
+bool fillAddress(const std::string& path, sockaddr_un& address) {
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Invalid socket path: " << path << std::endl;
+        return false;
+    }
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+std::vector<uint8_t> errorFrame(const FrameHeader& request, FrameStatus status) {
+    FrameWriter writer;
+    writer.begin(FrameHeader(request.requestId, static_cast<FrameType>(request.type), status));
+    writer.finish();
+    return writer.release();
+}
+
+} // namespace
+
+RoutingDaemon::RoutingDaemon(RoadGraph loaded, unsigned threads)
+    : graph(std::move(loaded)), listenFd(-1), epollFd(-1), wakeFd(-1), nextConnectionId(WAKE_ID + 1),
+      workerCount(std::max(1u, threads)), stopping(false), served(0) {
+    heuristic.build(graph);
+    spatialIndex = SpatialIndex::build(graph);
+    if (graph.hasNames()) {
+        for (NodeId node = 0; node < graph.nodeCount(); ++node) {
+            nameIndex.emplace(graph.name(node), node);
+        }
+    }
+}
+
+RoutingDaemon::~RoutingDaemon() {
+    stopping = true;
+    jobReady.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    for (auto& entry : connections) {
+        close(entry.second.fd);
+    }
+    if (listenFd >= 0) {
+        close(listenFd);
+        unlink(socketPath.c_str());
+    }
+    if (epollFd >= 0) close(epollFd);
+    if (wakeFd >= 0) close(wakeFd);
+}
+
+bool RoutingDaemon::listen(const std::string& path) {
+    sockaddr_un address;
+    if (!fillAddress(path, address)) {
+        return false;
+    }
+
+    // A socket file nobody accepts on is left over from a crash; a live one is an error
+    int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (probe >= 0) {
+        bool live = connect(probe, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+        close(probe);
+        if (live) {
+            std::cerr << "Socket already in use: " << path << std::endl;
+            return false;
+        }
+    }
+    unlink(path.c_str());
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        ::listen(listenFd, SOMAXCONN) < 0) {
+        std::cerr << "Error binding socket " << path << ": " << std::strerror(errno) << std::endl;
+        if (listenFd >= 0) close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    socketPath = path;
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || wakeFd < 0) {
+        std::cerr << "Error creating event loop: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = LISTEN_ID;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+    event.data.u64 = WAKE_ID;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+
+    for (unsigned i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&RoutingDaemon::workerLoop, this);
+    }
+    return true;
+}
+
+void RoutingDaemon::stop() {
+    stopping = true;
+    if (wakeFd >= 0) {
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeFd, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+bool RoutingDaemon::run() {
+    if (epollFd < 0) {
+        std::cerr << "Daemon is not listening" << std::endl;
+        return false;
+    }
+
+    epoll_event events[64];
+    while (!stopping) {
+        int count = epoll_wait(epollFd, events, 64, -1);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "epoll_wait failed: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        for (int i = 0; i < count; ++i) {
+            uint64_t id = events[i].data.u64;
+            if (id == LISTEN_ID) {
+                acceptConnections();
+            } else if (id == WAKE_ID) {
+                uint64_t wakeups;
+                while (read(wakeFd, &wakeups, sizeof(wakeups)) > 0) {}
+                deliverCompletions();
+            } else if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                closeConnection(id);
+            } else {
+                if (events[i].events & EPOLLIN) readConnection(id);
+                if ((events[i].events & EPOLLOUT) && connections.count(id)) flushConnection(id);
+            }
+        }
+    }
+    return true;
+}
+
+void RoutingDaemon::acceptConnections() {
+    while (true) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                std::cerr << "accept failed: " << std::strerror(errno) << std::endl;
+            }
+            return;
+        }
+
+        uint64_t id = nextConnectionId++;
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = id;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            close(fd);
+            continue;
+        }
+        Connection& connection = connections[id];
+        connection.fd = fd;
+        connection.outputOffset = 0;
+        connection.waitingToWrite = false;
+    }
+}
+
+void RoutingDaemon::readConnection(uint64_t id) {
+    auto it = connections.find(id);
+    if (it == connections.end()) {
+        return;
+    }
+    Connection& connection = it->second;
+
+    uint8_t chunk[READ_CHUNK];
+    while (true) {
+        ssize_t received = read(connection.fd, chunk, sizeof(chunk));
+        if (received > 0) {
+            connection.input.insert(connection.input.end(), chunk, chunk + received);
+            continue;
+        }
+        if (received < 0 && errno == EINTR) continue;
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        closeConnection(id); // orderly shutdown or error
+        return;
+    }
+
+    // Cut out every complete frame
+    std::vector<Job> batch;
+    size_t offset = 0;
+    while (connection.input.size() - offset >= FRAME_HEADER_SIZE) {
+        FrameHeader header = FrameReader::header(connection.input.data() + offset);
+        if (header.length > MAX_FRAME_PAYLOAD) {
+            std::cerr << "Dropping connection: " << header.length << "-byte frame" << std::endl;
+            closeConnection(id);
+            return;
+        }
+        if (connection.input.size() - offset - FRAME_HEADER_SIZE < header.length) {
+            break;
+        }
+        const uint8_t* payload = connection.input.data() + offset + FRAME_HEADER_SIZE;
+        batch.push_back(Job{id, header, std::vector<uint8_t>(payload, payload + header.length)});
+        offset += FRAME_HEADER_SIZE + header.length;
+    }
+    connection.input.erase(connection.input.begin(), connection.input.begin() + offset);
+    if (batch.empty()) {
+        return;
+    }
+
+    std::vector<FrameHeader> rejected;
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        for (Job& job : batch) {
+            if (jobs.size() >= MAX_QUEUED_JOBS) {
+                rejected.push_back(job.header);
+            } else {
+                jobs.push_back(std::move(job));
+            }
+        }
+    }
+    if (batch.size() - rejected.size() > 1) {
+        jobReady.notify_all();
+    } else {
+        jobReady.notify_one();
+    }
+    for (const FrameHeader& header : rejected) {
+        reject(id, header, FrameStatus::Overloaded);
+    }
+}
+
+void RoutingDaemon::reject(uint64_t id, const FrameHeader& request, FrameStatus status) {
+    auto it = connections.find(id);
+    if (it == connections.end()) {
+        return;
+    }
+    std::vector<uint8_t> frame = errorFrame(request, status);
+    it->second.output.insert(it->second.output.end(), frame.begin(), frame.end());
+    flushConnection(id);
+}
+
+void RoutingDaemon::flushConnection(uint64_t id) {
+    auto it = connections.find(id);
+    if (it == connections.end()) {
+        return;
+    }
+    Connection& connection = it->second;
+
+    while (connection.outputOffset < connection.output.size()) {
+        ssize_t sent = send(connection.fd, connection.output.data() + connection.outputOffset,
+                            connection.output.size() - connection.outputOffset, MSG_NOSIGNAL);
+        if (sent > 0) {
+            connection.outputOffset += sent;
+            continue;
+        }
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // Kernel buffer full: resume when the socket drains
+            if (!connection.waitingToWrite) {
+                epoll_event event{};
+                event.events = EPOLLIN | EPOLLOUT;
+                event.data.u64 = id;
+                epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+                connection.waitingToWrite = true;
+            }
+            return;
+        }
+        closeConnection(id);
+        return;
+    }
+
+    connection.output.clear();
+    connection.outputOffset = 0;
+    if (connection.waitingToWrite) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = id;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+        connection.waitingToWrite = false;
+    }
+}
+
+void RoutingDaemon::closeConnection(uint64_t id) {
+    auto it = connections.find(id);
+    if (it == connections.end()) {
+        return;
+    }
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+    close(it->second.fd);
+    connections.erase(it);
+}
+
+void RoutingDaemon::deliverCompletions() {
+    std::vector<Completion> finished;
+    {
+        std::lock_guard<std::mutex> lock(completionMutex);
+        finished.swap(completions);
+    }
+
+    // Queue everything first so each connection gets one write
+    std::vector<uint64_t> touched;
+    for (Completion& completion : finished) {
+        auto it = connections.find(completion.connection);
+        if (it == connections.end()) {
+            continue; // client went away
+        }
+        it->second.output.insert(it->second.output.end(), completion.frame.begin(), completion.frame.end());
+        touched.push_back(completion.connection);
+    }
+    std::sort(touched.begin(), touched.end());
+    touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+    for (uint64_t id : touched) {
+        flushConnection(id);
+    }
+}
+
+void RoutingDaemon::workerLoop() {
+    DijkstraSearch search;
+    BidirectionalSearch bidirectional;
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobReady.wait(lock, [this]() { return stopping || !jobs.empty(); });
+            if (stopping) {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        std::vector<uint8_t> frame = handle(job, search, bidirectional);
+        served++;
+        {
+            std::lock_guard<std::mutex> lock(completionMutex);
+            completions.push_back(Completion{job.connection, std::move(frame)});
+        }
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeFd, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+bool RoutingDaemon::resolve(FrameReader& reader, NodeId& node) const {
+    switch (static_cast<NodeRefKind>(reader.u8())) {
+        case NodeRefKind::Id:
+            node = reader.u32();
+            return reader.ok() && node < graph.nodeCount();
+        case NodeRefKind::Name: {
+            std::string name = reader.string();
+            auto it = nameIndex.find(name);
+            node = it != nameIndex.end() ? it->second : INVALID_NODE;
+            return reader.ok() && node != INVALID_NODE;
+        }
+        case NodeRefKind::Coordinates: {
+            double latitude = reader.f64();
+            double longitude = reader.f64();
+            // Raw wire doubles: NaN or out-of-range positions are a bad request, not a lookup
+            if (!std::isfinite(latitude) || !std::isfinite(longitude) ||
+                std::abs(latitude) > 90.0 || std::abs(longitude) > 180.0) {
+                reader.fail();
+            }
+            node = reader.ok() ? spatialIndex.nearest(latitude, longitude).node : INVALID_NODE;
+            return node != INVALID_NODE;
+        }
+    }
+    return false;
+}
+
+std::vector<uint8_t> RoutingDaemon::handle(const Job& job, DijkstraSearch& search,
+                                           BidirectionalSearch& bidirectional) {
+    FrameReader reader(job.payload.data(), job.payload.size());
+    FrameWriter writer;
+    FrameType type = static_cast<FrameType>(job.header.type);
+
+    switch (type) {
+        case FrameType::Route: {
+            Metric metric = reader.u8() == 1 ? Metric::Time : Metric::Distance;
+            RouteAlgorithm algorithm = static_cast<RouteAlgorithm>(reader.u8());
+            NodeId from, to;
+            bool found = resolve(reader, from);
+            found = resolve(reader, to) && found;
+            if (!reader.ok()) return errorFrame(job.header, FrameStatus::BadRequest);
+            if (!found) return errorFrame(job.header, FrameStatus::NotFound);
+
+            std::vector<NodeId> path;
+            size_t settled = 0;
+            if (algorithm == RouteAlgorithm::Bidirectional) {
+                bidirectional.run(graph, from, to, metric);
+                path = bidirectional.path();
+                settled = bidirectional.settledCount();
+            } else {
+                if (algorithm == RouteAlgorithm::AStar && !heuristic.empty()) {
+                    search.runAStar(graph, from, to, metric, heuristic);
+                } else {
+                    search.run(graph, from, to, metric);
+                }
+                path = search.pathTo(to);
+                settled = search.settledCount();
+            }
+            if (path.empty()) return errorFrame(job.header, FrameStatus::NotFound);
+
+            double distance = 0.0, time = 0.0;
+            for (size_t i = 0; i + 1 < path.size(); ++i) {
+                EdgeId edge = graph.findEdge(path[i], path[i + 1]);
+                distance += graph.distance(edge);
+                time += graph.time(edge);
+            }
+            writer.begin(FrameHeader(job.header.requestId, type));
+            writer.f64(distance);
+            writer.f64(time);
+            writer.u32(static_cast<uint32_t>(settled));
+            writer.u32(static_cast<uint32_t>(path.size()));
+            for (NodeId node : path) {
+                writer.u32(node);
+                writer.string(graph.hasNames() ? graph.name(node) : std::string());
+            }
+            break;
+        }
+        case FrameType::Matrix: {
+            Metric metric = reader.u8() == 1 ? Metric::Time : Metric::Distance;
+            uint32_t rows = reader.u32();
+            uint32_t cols = reader.u32();
+            // rows * cols alone lets rows = 0 pair with any cols, so bound the
+            // NodeRef count by the payload before allocating for it
+            if (!reader.ok() || rows == 0 || cols == 0 || static_cast<uint64_t>(rows) * cols > MAX_MATRIX_CELLS ||
+                static_cast<uint64_t>(rows) + cols > reader.remaining() / MIN_NODE_REF_SIZE) {
+                return errorFrame(job.header, FrameStatus::BadRequest);
+            }
+            std::vector<NodeId> sources(rows), targets(cols);
+            bool found = true;
+            for (NodeId& node : sources) found = resolve(reader, node) && found;
+            for (NodeId& node : targets) found = resolve(reader, node) && found;
+            if (!reader.ok()) return errorFrame(job.header, FrameStatus::BadRequest);
+            if (!found) return errorFrame(job.header, FrameStatus::NotFound);
+
+            // The pool already runs one request per core
+            DistanceMatrix matrix = DistanceMatrix::compute(graph, sources, targets, metric, 1);
+            writer.begin(FrameHeader(job.header.requestId, type));
+            writer.u32(rows);
+            writer.u32(cols);
+            for (double value : matrix.data()) {
+                writer.f64(value);
+            }
+            break;
+        }
+        case FrameType::Sort: {
+            SortAlgorithm algorithm = static_cast<SortAlgorithm>(reader.u8());
+            uint32_t count = reader.u32();
+            if (!reader.ok() || reader.remaining() != static_cast<size_t>(count) * sizeof(int32_t)) {
+                return errorFrame(job.header, FrameStatus::BadRequest);
+            }
+            std::vector<int32_t> values(count);
+            for (int32_t& value : values) {
+                value = reader.i32();
+            }
+            switch (algorithm) {
+                case SortAlgorithm::MergeSort:
+                    std::stable_sort(values.begin(), values.end());
+                    break;
+                case SortAlgorithm::HeapSort:
+                    std::make_heap(values.begin(), values.end());
+                    std::sort_heap(values.begin(), values.end());
+                    break;
+                default:
+                    std::sort(values.begin(), values.end());
+                    break;
+            }
+            writer.begin(FrameHeader(job.header.requestId, type));
+            writer.u32(count);
+            for (int32_t value : values) {
+                writer.i32(value);
+            }
+            break;
+        }
+        case FrameType::Status:
+            writer.begin(FrameHeader(job.header.requestId, type));
+            writer.u32(static_cast<uint32_t>(graph.nodeCount()));
+            writer.u32(static_cast<uint32_t>(graph.edgeCount()));
+            writer.u32(workerCount);
+            writer.u64(served.load());
+            break;
+        default:
+            return errorFrame(job.header, FrameStatus::UnknownType);
+    }
+
+    writer.finish();
+    return writer.release();
+}
@@ -0,0 +1,108 @@
+#ifndef ROUTING_DAEMON_H
+#define ROUTING_DAEMON_H
+
+#include "road_graph.h"
+#include "shortest_path.h"
+#include "spatial_index.h"
+#include "daemon_protocol.h"
+#include "parallel.h"
+#include <vector>
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+/**
+ * Routing Daemon
+ * Long-running server that keeps one graph in memory and answers route,
+ * matrix, sort and status requests (daemon_protocol.h) on a Unix domain
+ * socket. A single epoll loop owns every socket: it accepts connections,
+ * reads non-blocking, cuts complete frames out of each connection's input
+ * buffer and queues them for a pool of worker threads. Each worker keeps
+ * its own search workspaces, so queries never share mutable state. Workers
+ * post finished response frames back to the loop and wake it through an
+ * eventfd. The loop writes them out, switching a connection to EPOLLOUT
+ * only while its kernel buffer is full.
+ */
+
+class RoutingDaemon {
+private:
+    static const size_t MAX_QUEUED_JOBS = 4096; // beyond this requests get Overloaded
+
+    struct Job {
+        uint64_t connection;
+        FrameHeader header;
+        std::vector<uint8_t> payload;
+    };
+
+    struct Completion {
+        uint64_t connection;
+        std::vector<uint8_t> frame;
+    };
+
+    struct Connection {
+        int fd;
+        std::vector<uint8_t> input;
+        std::vector<uint8_t> output;
+        size_t outputOffset; // bytes of output already written
+        bool waitingToWrite; // registered for EPOLLOUT
+    };
+
+    RoadGraph graph;
+    GeoHeuristic heuristic;
+    SpatialIndex spatialIndex;
+    std::unordered_map<std::string, NodeId> nameIndex;
+
+    std::string socketPath;
+    int listenFd;
+    int epollFd;
+    int wakeFd;
+    std::unordered_map<uint64_t, Connection> connections;
+    uint64_t nextConnectionId;
+
+    unsigned workerCount;
+    std::vector<std::thread> workers;
+    std::mutex jobMutex;
+    std::condition_variable jobReady;
+    std::deque<Job> jobs;
+    std::mutex completionMutex;
+    std::vector<Completion> completions;
+    std::atomic<bool> stopping;
+    std::atomic<uint64_t> served;
+
+    void acceptConnections();
+    void readConnection(uint64_t id);
+    void flushConnection(uint64_t id);
+    void closeConnection(uint64_t id);
+    void deliverCompletions();
+    void reject(uint64_t id, const FrameHeader& request, FrameStatus status);
+
+    void workerLoop();
+    std::vector<uint8_t> handle(const Job& job, DijkstraSearch& search, BidirectionalSearch& bidirectional);
+    bool resolve(FrameReader& reader, NodeId& node) const;
+
+public:
+    // Takes ownership of the graph; workers start in listen()
+    RoutingDaemon(RoadGraph loaded, unsigned threads = defaultThreadCount());
+    ~RoutingDaemon();
+
+    RoutingDaemon(const RoutingDaemon&) = delete;
+    RoutingDaemon& operator=(const RoutingDaemon&) = delete;
+
+    // Binds the socket (replacing a stale file) and starts the workers
+    bool listen(const std::string& path);
+
+    // Serves until stop(); returns false if the event loop failed
+    bool run();
+
+    // Async-signal-safe: flags the loop and wakes it
+    void stop();
+
+    const RoadGraph& getGraph() const { return graph; }
+    uint64_t requestsServed() const { return served.load(); }
+};
+
+#endif // ROUTING_DAEMON_H
@@ -0,0 +1,101 @@
+#include "routing_daemon.h"
+#include "pathfinding.h"
+#include "graph_generators.h"
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <csignal>
+
+/**
+ * Routing Daemon
+ * Loads one graph and serves it on a Unix socket until SIGINT/SIGTERM.
+ * Usage: routing_daemon [--socket PATH] [--workers N]
+ *                       [--snapshot FILE | --cities FILE --routes FILE | --generate KIND NODES]
+ * Without a graph option the built-in city network is served.
+ */
+
+static RoutingDaemon* activeDaemon = nullptr;
+
+static void handleSignal(int) {
+    if (activeDaemon) {
+        activeDaemon->stop();
+    }
+}
+
+static void printUsage() {
+    std::cerr << "Usage: routing_daemon [--socket PATH] [--workers N]\n"
+              << "                      [--snapshot FILE | --cities FILE --routes FILE | --generate KIND NODES]"
+              << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::string socketPath = "/tmp/pathfinding.sock";
+    std::string snapshotFile, citiesFile, routesFile, generateKind;
+    size_t generateNodes = 0;
+    unsigned workers = defaultThreadCount();
+
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (option == "--socket" && hasValue) {
+            socketPath = argv[++i];
+        } else if (option == "--workers" && hasValue) {
+            workers = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (option == "--snapshot" && hasValue) {
+            snapshotFile = argv[++i];
+        } else if (option == "--cities" && hasValue) {
+            citiesFile = argv[++i];
+        } else if (option == "--routes" && hasValue) {
+            routesFile = argv[++i];
+        } else if (option == "--generate" && i + 2 < argc) {
+            generateKind = argv[++i];
+            generateNodes = std::strtoul(argv[++i], nullptr, 10);
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (workers == 0) {
+        workers = 1;
+    }
+
+    RoadGraph graph;
+    if (!snapshotFile.empty()) {
+        if (!graph.load(snapshotFile)) {
+            return 1;
+        }
+    } else if (!generateKind.empty()) {
+        graph = generateGraph(generateKind, generateNodes, 42);
+        if (graph.nodeCount() == 0) {
+            std::cerr << "Unknown graph kind: " << generateKind << std::endl;
+            return 1;
+        }
+    } else {
+        PathfindingVisualizer visualizer;
+        if (!citiesFile.empty() || !routesFile.empty()) {
+            if (!visualizer.loadNetworkFromFiles(citiesFile, routesFile)) {
+                return 1;
+            }
+        }
+        graph = visualizer.getRoadGraph();
+    }
+
+    size_t nodes = graph.nodeCount(), arcs = graph.edgeCount();
+    RoutingDaemon daemon(std::move(graph), workers);
+    if (!daemon.listen(socketPath)) {
+        return 1;
+    }
+
+    activeDaemon = &daemon;
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::cout << "Serving " << nodes << " nodes / " << arcs << " arcs on " << socketPath
+              << " with " << workers << " workers" << std::endl;
+    bool clean = daemon.run();
+    activeDaemon = nullptr;
+    std::cout << "Stopped after " << daemon.requestsServed() << " requests" << std::endl;
+    return clean ? 0 : 1;
+}
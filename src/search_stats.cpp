@@ -0,0 +1,168 @@
+#include "search_stats.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+const size_t SUB_BUCKETS = 4; // per power of two
+const size_t HISTOGRAM_BUCKETS = 1 + 48 * SUB_BUCKETS;
+
+size_t bucketFor(double value) {
+    if (!(value >= 1.0)) {
+        return 0;
+    }
+    int exponent;
+    double mantissa = std::frexp(value, &exponent); // value = mantissa * 2^exponent, mantissa in [0.5, 1)
+    size_t sub = static_cast<size_t>((mantissa * 2.0 - 1.0) * SUB_BUCKETS);
+    return std::min(1 + (exponent - 1) * SUB_BUCKETS + sub, HISTOGRAM_BUCKETS - 1);
+}
+
+double bucketUpperBound(size_t bucket) {
+    if (bucket == 0) {
+        return 1.0;
+    }
+    size_t octave = (bucket - 1) / SUB_BUCKETS;
+    size_t sub = (bucket - 1) % SUB_BUCKETS;
+    return std::ldexp(1.0 + static_cast<double>(sub + 1) / SUB_BUCKETS, static_cast<int>(octave));
+}
+
+std::string jsonString(const std::string& text) {
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') quoted += '\\';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+} // namespace
+
+std::string searchPhaseName(SearchPhase phase) {
+    switch (phase) {
+        case SearchPhase::Lookup: return "lookup";
+        case SearchPhase::Search: return "search";
+        case SearchPhase::Unpack: return "unpack";
+    }
+    return "unknown";
+}
+
+double SearchStats::totalMicros() const {
+    double total = 0.0;
+    for (double micros : phaseMicros) total += micros;
+    return total;
+}
+
+Histogram::Histogram() : buckets(HISTOGRAM_BUCKETS, 0), samples(0), sum(0.0), maxValue(0.0) {}
+
+void Histogram::add(double value) {
+    buckets[bucketFor(value)]++;
+    samples++;
+    sum += value;
+    maxValue = std::max(maxValue, value);
+}
+
+void Histogram::merge(const Histogram& other) {
+    for (size_t b = 0; b < HISTOGRAM_BUCKETS; ++b) {
+        buckets[b] += other.buckets[b];
+    }
+    samples += other.samples;
+    sum += other.sum;
+    maxValue = std::max(maxValue, other.maxValue);
+}
+
+double Histogram::percentile(double fraction) const {
+    if (samples == 0) {
+        return 0.0;
+    }
+    size_t rank = static_cast<size_t>(std::ceil(std::clamp(fraction, 0.0, 1.0) * samples));
+    size_t seen = 0;
+    for (size_t b = 0; b < HISTOGRAM_BUCKETS; ++b) {
+        seen += buckets[b];
+        if (seen >= std::max<size_t>(rank, 1)) {
+            return std::min(bucketUpperBound(b), maxValue);
+        }
+    }
+    return maxValue;
+}
+
+std::string Histogram::toJson() const {
+    std::ostringstream out;
+    out << "{\"count\": " << samples << ", \"mean\": " << mean() << ", \"max\": " << maxValue
+        << ", \"p50\": " << percentile(0.5) << ", \"p90\": " << percentile(0.9)
+        << ", \"p99\": " << percentile(0.99) << ", \"p999\": " << percentile(0.999) << ", \"buckets\": [";
+    bool first = true;
+    for (size_t b = 0; b < HISTOGRAM_BUCKETS; ++b) {
+        if (buckets[b] == 0) continue;
+        out << (first ? "" : ", ") << "{\"le\": " << bucketUpperBound(b) << ", \"count\": " << buckets[b] << "}";
+        first = false;
+    }
+    out << "]}";
+    return out.str();
+}
+
+QueryStatsCollector::AlgorithmStats::AlgorithmStats() : queries(0), cacheHits(0) {
+    for (double& micros : phaseMicros) micros = 0.0;
+}
+
+void QueryStatsCollector::record(const std::string& algorithm, const SearchStats& stats) {
+    AlgorithmStats& entry = algorithms[algorithm];
+    entry.queries++;
+    entry.latencyMicros.add(stats.totalMicros());
+    for (size_t p = 0; p < SEARCH_PHASE_COUNT; ++p) {
+        entry.phaseMicros[p] += stats.phaseMicros[p];
+    }
+    // Cache hits did no search work; keep them out of the work histograms
+    if (stats.cacheHit) {
+        entry.cacheHits++;
+        return;
+    }
+    entry.settled.add(stats.settled);
+    entry.relaxed.add(stats.relaxed);
+    entry.pushes.add(stats.pushes);
+    entry.peakQueueSize.add(stats.peakQueueSize);
+}
+
+double QueryStatsCollector::latencyPercentile(const std::string& algorithm, double fraction) const {
+    auto it = algorithms.find(algorithm);
+    return it != algorithms.end() ? it->second.latencyMicros.percentile(fraction) : 0.0;
+}
+
+std::string QueryStatsCollector::toJson() const {
+    std::ostringstream out;
+    out << "{\n  \"instrumented\": " << (SEARCH_STATS_ENABLED ? "true" : "false") << ",\n  \"algorithms\": {";
+    bool first = true;
+    for (const auto& entry : algorithms) {
+        const AlgorithmStats& stats = entry.second;
+        out << (first ? "\n" : ",\n") << "    " << jsonString(entry.first) << ": {\n"
+            << "      \"queries\": " << stats.queries << ",\n"
+            << "      \"cacheHits\": " << stats.cacheHits << ",\n"
+            << "      \"latencyMicros\": " << stats.latencyMicros.toJson() << ",\n"
+            << "      \"phaseMicros\": {";
+        for (size_t p = 0; p < SEARCH_PHASE_COUNT; ++p) {
+            out << (p > 0 ? ", " : "") << jsonString(searchPhaseName(static_cast<SearchPhase>(p))) << ": "
+                << stats.phaseMicros[p];
+        }
+        out << "},\n"
+            << "      \"settled\": " << stats.settled.toJson() << ",\n"
+            << "      \"relaxed\": " << stats.relaxed.toJson() << ",\n"
+            << "      \"pushes\": " << stats.pushes.toJson() << ",\n"
+            << "      \"peakQueueSize\": " << stats.peakQueueSize.toJson() << "\n"
+            << "    }";
+        first = false;
+    }
+    out << (first ? "}\n}\n" : "\n  }\n}\n");
+    return out.str();
+}
+
+bool QueryStatsCollector::exportJson(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error opening file: " << filename << std::endl;
+        return false;
+    }
+    file << toJson();
+    return true;
+}
@@ -0,0 +1,142 @@
+#ifndef SEARCH_STATS_H
+#define SEARCH_STATS_H
+
+#include <vector>
+#include <string>
+#include <map>
+#include <chrono>
+
+/**
+ * Per-Query Search Instrumentation
+ * Counters and phase timers filled in by the search engines and the
+ * visualizer, plus log-scale histograms that aggregate them per
+ * algorithm for export as JSON. Settled and relaxed counts are always
+ * kept, since the engines need them anyway. Queue pushes/pops, peak queue
+ * size, phase times and histogram collection are compiled in only with
+ * -DPATHFINDING_STATS (make STATS=1); otherwise the hooks are empty
+ * inline functions and cost nothing.
+ */
+
+#ifdef PATHFINDING_STATS
+constexpr bool SEARCH_STATS_ENABLED = true;
+#else
+constexpr bool SEARCH_STATS_ENABLED = false;
+#endif
+
+enum class SearchPhase {
+    Lookup, // name resolution and result-cache probe
+    Search, // the engine itself, including hot-tree builds
+    Unpack  // node path to PathResult
+};
+
+const size_t SEARCH_PHASE_COUNT = 3;
+
+std::string searchPhaseName(SearchPhase phase);
+
+struct SearchStats {
+    size_t settled;
+    size_t relaxed;
+    size_t pushes;        // inserts and decrease-keys
+    size_t pops;          // including stale entries skipped by lazy queues
+    size_t peakQueueSize;
+    double phaseMicros[SEARCH_PHASE_COUNT];
+    bool cacheHit;
+
+    SearchStats() { reset(); }
+
+    void reset() {
+        settled = relaxed = pushes = pops = peakQueueSize = 0;
+        for (double& micros : phaseMicros) micros = 0.0;
+        cacheHit = false;
+    }
+
+    // Queue hooks for the engines' inner loops
+    void countPush(size_t queueSize) {
+        if constexpr (SEARCH_STATS_ENABLED) {
+            ++pushes;
+            if (queueSize > peakQueueSize) peakQueueSize = queueSize;
+        }
+    }
+    void countPop() {
+        if constexpr (SEARCH_STATS_ENABLED) ++pops;
+    }
+
+    double totalMicros() const;
+};
+
+// Adds the wall time of its scope to one phase of `stats`
+class PhaseTimer {
+private:
+    SearchStats& stats;
+    SearchPhase phase;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    PhaseTimer(SearchStats& s, SearchPhase p) : stats(s), phase(p) {
+        if constexpr (SEARCH_STATS_ENABLED) start = std::chrono::steady_clock::now();
+    }
+    ~PhaseTimer() {
+        if constexpr (SEARCH_STATS_ENABLED) {
+            stats.phaseMicros[static_cast<size_t>(phase)] +=
+                std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+};
+
+// Log-linear buckets: values below 1 share one bucket, every power of two
+// above is split into four equal buckets, so any value is off by at most
+// 25%. Percentiles are bucket upper bounds, capped at the maximum.
+class Histogram {
+private:
+    std::vector<size_t> buckets;
+    size_t samples;
+    double sum;
+    double maxValue;
+
+public:
+    Histogram();
+
+    void add(double value);
+    void merge(const Histogram& other);
+
+    size_t count() const { return samples; }
+    double mean() const { return samples > 0 ? sum / samples : 0.0; }
+    double max() const { return maxValue; }
+    double percentile(double fraction) const;
+
+    std::string toJson() const;
+};
+
+// Latency and work histograms per algorithm name
+class QueryStatsCollector {
+private:
+    struct AlgorithmStats {
+        size_t queries;
+        size_t cacheHits;
+        Histogram latencyMicros;
+        Histogram settled;
+        Histogram relaxed;
+        Histogram pushes;
+        Histogram peakQueueSize;
+        double phaseMicros[SEARCH_PHASE_COUNT]; // totals
+
+        AlgorithmStats();
+    };
+
+    std::map<std::string, AlgorithmStats> algorithms;
+
+public:
+    void record(const std::string& algorithm, const SearchStats& stats);
+    void clear() { algorithms.clear(); }
+    bool empty() const { return algorithms.empty(); }
+
+    // Latency percentile over every recorded query of `algorithm`, 0 when none
+    double latencyPercentile(const std::string& algorithm, double fraction) const;
+
+    std::string toJson() const;
+    bool exportJson(const std::string& filename) const;
+};
+
+#endif // SEARCH_STATS_H
@@ -0,0 +1,382 @@
+#include "shortest_path.h"
+#include "landmarks.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const double EARTH_RADIUS_KM = 6371.0;
+const double DEG_TO_RAD = M_PI / 180.0;
+
+struct ZeroPotential {
+    double operator()(NodeId) const { return 0.0; }
+};
+
+struct GeoPotential {
+    const GeoHeuristic& heuristic;
+    NodeId target;
+    Metric metric;
+    HeuristicMode mode;
+
+    double operator()(NodeId node) const { return heuristic.estimate(node, target, metric, mode); }
+};
+
+struct LandmarkPotential {
+    const LandmarkTable& landmarks;
+    NodeId target;
+    std::vector<uint32_t> active;
+
+    double operator()(NodeId node) const { return landmarks.lowerBound(node, target, active); }
+};
+
+struct AveragePotential {
+    const GeoHeuristic& heuristic;
+    NodeId source;
+    NodeId target;
+    Metric metric;
+
+    double operator()(NodeId node) const {
+        return 0.5 * (heuristic.estimate(node, target, metric, HeuristicMode::Haversine)
+                    - heuristic.estimate(source, node, metric, HeuristicMode::Haversine));
+    }
+};
+
+} // namespace
+
+std::string queueTypeName(QueueType queue) {
+    switch (queue) {
+        case QueueType::BinaryHeap: return "Binary Heap";
+        case QueueType::QuaternaryHeap: return "4-ary Heap";
+        case QueueType::PairingHeap: return "Pairing Heap";
+        case QueueType::RadixHeap: return "Radix Heap";
+    }
+    return "Unknown";
+}
+
+GeoHeuristic::GeoHeuristic() : equirectScale(1.0), maxSpeed(INFINITE_WEIGHT) {}
+
+void GeoHeuristic::build(const RoadGraph& graph) {
+    latRad.clear();
+    lonRad.clear();
+    cosLat.clear();
+    equirectScale = 1.0;
+    maxSpeed = 0.0;
+
+    if (!graph.hasCoordinates() || graph.nodeCount() == 0) {
+        maxSpeed = INFINITE_WEIGHT;
+        return;
+    }
+
+    double minLat = INFINITE_WEIGHT, maxLat = -INFINITE_WEIGHT;
+    double minLon = INFINITE_WEIGHT, maxLon = -INFINITE_WEIGHT;
+    for (NodeId node = 0; node < graph.nodeCount(); ++node) {
+        double lat = graph.latitude(node) * DEG_TO_RAD;
+        double lon = graph.longitude(node) * DEG_TO_RAD;
+        latRad.push_back(lat);
+        lonRad.push_back(lon);
+        cosLat.push_back(std::cos(lat));
+        minLat = std::min(minLat, lat);
+        maxLat = std::max(maxLat, lat);
+        minLon = std::min(minLon, lon);
+        maxLon = std::max(maxLon, lon);
+    }
+
+    // sin(x)/x is decreasing, so its value at half the widest angular span
+    // bounds 2*sin(d/2) >= d*scale for every coordinate difference d in the graph
+    double span = std::min(std::max(maxLat - minLat, maxLon - minLon), M_PI);
+    if (span > 0.0) {
+        equirectScale = std::sin(span / 2) / (span / 2);
+    }
+
+    for (EdgeId edge = 0; edge < graph.edgeCount(); ++edge) {
+        if (graph.time(edge) > 0.0) {
+            maxSpeed = std::max(maxSpeed, graph.distance(edge) / graph.time(edge));
+        } else if (graph.distance(edge) > 0.0) {
+            maxSpeed = INFINITE_WEIGHT;
+        }
+    }
+}
+
+double GeoHeuristic::haversine(NodeId from, NodeId to) const {
+    double sinLat = std::sin((latRad[to] - latRad[from]) / 2);
+    double sinLon = std::sin((lonRad[to] - lonRad[from]) / 2);
+    double a = sinLat * sinLat + cosLat[from] * cosLat[to] * sinLon * sinLon;
+    return 2 * EARTH_RADIUS_KM * std::asin(std::min(1.0, std::sqrt(a)));
+}
+
+double GeoHeuristic::equirectangular(NodeId from, NodeId to) const {
+    // Never exceeds the chord length, which never exceeds the great-circle distance
+    double dLat = latRad[to] - latRad[from];
+    double dLon = std::fabs(lonRad[to] - lonRad[from]);
+    if (dLon > M_PI) dLon = 2 * M_PI - dLon;
+    double x = dLon * std::min(cosLat[from], cosLat[to]);
+    return EARTH_RADIUS_KM * equirectScale * std::sqrt(dLat * dLat + x * x);
+}
+
+double GeoHeuristic::estimate(NodeId from, NodeId to, Metric metric, HeuristicMode mode) const {
+    if (latRad.empty()) {
+        return 0.0;
+    }
+    // No edge with a positive length leaves no speed to convert with; zero stays admissible
+    if (metric == Metric::Time && !(maxSpeed > 0.0)) {
+        return 0.0;
+    }
+    double km = mode == HeuristicMode::Haversine ? haversine(from, to) : equirectangular(from, to);
+    return metric == Metric::Distance ? km : km / maxSpeed;
+}
+
+DijkstraSearch::DijkstraSearch() : currentStamp(0), settled(0), relaxed(0) {}
+
+void DijkstraSearch::prepare(size_t nodeCount) {
+    if (stamp.size() != nodeCount) {
+        dist.assign(nodeCount, INFINITE_WEIGHT);
+        parentEdge.assign(nodeCount, INVALID_EDGE);
+        parent.assign(nodeCount, INVALID_NODE);
+        stamp.assign(nodeCount, 0);
+        currentStamp = 0;
+    }
+    if (++currentStamp == 0) {
+        // Stamp wrapped around - invalidate everything explicitly
+        std::fill(stamp.begin(), stamp.end(), 0);
+        currentStamp = 1;
+    }
+    settled = 0;
+    relaxed = 0;
+    queueStats.reset();
+}
+
+// Dijkstra on reduced costs when given a potential (A*). Nodes whose distance
+// improves after expansion are queued again, so admissible but inconsistent
+// potentials still yield exact distances at the target.
+template <typename Queue, typename Potential>
+void DijkstraSearch::runWithQueue(Queue& queue, const RoadGraph& graph, NodeId source, NodeId target, Metric metric,
+                                  const Potential& potential) {
+    queue.clear();
+    queue.reserve(graph.nodeCount());
+
+    stamp[source] = currentStamp;
+    dist[source] = 0.0;
+    parent[source] = INVALID_NODE;
+    parentEdge[source] = INVALID_EDGE;
+    queue.push(source, potential(source));
+    queueStats.countPush(queue.size());
+
+    while (!queue.empty()) {
+        HeapEntry<double> top = queue.pop();
+        queueStats.countPop();
+        NodeId current = top.node;
+        if (top.key > dist[current] + potential(current)) {
+            continue; // stale entry from a lazy queue
+        }
+        settled++;
+
+        if (current == target) {
+            break;
+        }
+
+        for (EdgeId e = graph.firstEdge(current); e < graph.endEdge(current); ++e) {
+            NodeId neighbor = graph.target(e);
+            double newDistance = dist[current] + graph.weight(e, metric);
+            relaxed++;
+            if (!reached(neighbor) || newDistance < dist[neighbor]) {
+                stamp[neighbor] = currentStamp;
+                dist[neighbor] = newDistance;
+                parent[neighbor] = current;
+                parentEdge[neighbor] = e;
+                queue.push(neighbor, newDistance + potential(neighbor));
+                queueStats.countPush(queue.size());
+            }
+        }
+    }
+}
+
+void DijkstraSearch::run(const RoadGraph& graph, NodeId source, NodeId target, Metric metric, QueueType queue) {
+    prepare(graph.nodeCount());
+    ZeroPotential zero;
+
+    switch (queue) {
+        case QueueType::BinaryHeap:
+            runWithQueue(binaryHeap, graph, source, target, metric, zero);
+            break;
+        case QueueType::QuaternaryHeap:
+            runWithQueue(quaternaryHeap, graph, source, target, metric, zero);
+            break;
+        case QueueType::PairingHeap:
+            runWithQueue(pairingHeap, graph, source, target, metric, zero);
+            break;
+        case QueueType::RadixHeap:
+            runWithQueue(radixHeap, graph, source, target, metric, zero);
+            break;
+    }
+}
+
+void DijkstraSearch::runAStar(const RoadGraph& graph, NodeId source, NodeId target, Metric metric,
+                              const GeoHeuristic& heuristic, HeuristicMode mode, QueueType queue) {
+    prepare(graph.nodeCount());
+    GeoPotential potential{heuristic, target, metric, mode};
+
+    switch (queue) {
+        case QueueType::BinaryHeap:
+            runWithQueue(binaryHeap, graph, source, target, metric, potential);
+            break;
+        case QueueType::PairingHeap:
+            runWithQueue(pairingHeap, graph, source, target, metric, potential);
+            break;
+        case QueueType::QuaternaryHeap:
+        case QueueType::RadixHeap:
+            runWithQueue(quaternaryHeap, graph, source, target, metric, potential);
+            break;
+    }
+}
+
+void DijkstraSearch::runALT(const RoadGraph& graph, NodeId source, NodeId target, const LandmarkTable& landmarks) {
+    prepare(graph.nodeCount());
+    LandmarkPotential potential{landmarks, target, landmarks.selectActive(source, target)};
+    runWithQueue(quaternaryHeap, graph, source, target, landmarks.getMetric(), potential);
+}
+
+std::vector<NodeId> DijkstraSearch::pathTo(NodeId node) const {
+    std::vector<NodeId> path;
+    if (node >= stamp.size() || !reached(node)) {
+        return path;
+    }
+
+    for (NodeId current = node; current != INVALID_NODE; current = parent[current]) {
+        path.push_back(current);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+SearchStats DijkstraSearch::searchStats() const {
+    SearchStats stats = queueStats;
+    stats.settled = settled;
+    stats.relaxed = relaxed;
+    return stats;
+}
+
+BidirectionalSearch::BidirectionalSearch()
+    : currentStamp(0), meetingNode(INVALID_NODE), bestDistance(INFINITE_WEIGHT), settled(0), relaxed(0) {}
+
+void BidirectionalSearch::prepare(size_t nodeCount) {
+    if (forward.stamp.size() != nodeCount) {
+        for (Side* side : {&forward, &backward}) {
+            side->dist.assign(nodeCount, INFINITE_WEIGHT);
+            side->parent.assign(nodeCount, INVALID_NODE);
+            side->stamp.assign(nodeCount, 0);
+        }
+        currentStamp = 0;
+    }
+    if (++currentStamp == 0) {
+        std::fill(forward.stamp.begin(), forward.stamp.end(), 0);
+        std::fill(backward.stamp.begin(), backward.stamp.end(), 0);
+        currentStamp = 1;
+    }
+    forward.queue.clear();
+    backward.queue.clear();
+    forward.queue.reserve(nodeCount);
+    backward.queue.reserve(nodeCount);
+    meetingNode = INVALID_NODE;
+    bestDistance = INFINITE_WEIGHT;
+    settled = 0;
+    relaxed = 0;
+    queueStats.reset();
+}
+
+// Forward keys are d_f(v) + p(v) and backward keys d_b(v) - p(v), so the
+// potentials cancel for any meeting node and top_f + top_b >= mu is the
+// plain stopping criterion in both the Dijkstra and the A* case.
+template <typename Potential>
+void BidirectionalSearch::runWithPotential(const RoadGraph& graph, NodeId source, NodeId target, Metric metric,
+                                           const Potential& potential) {
+    prepare(graph.nodeCount());
+
+    forward.stamp[source] = currentStamp;
+    forward.dist[source] = 0.0;
+    forward.parent[source] = INVALID_NODE;
+    forward.queue.push(source, potential(source));
+    queueStats.countPush(1);
+
+    backward.stamp[target] = currentStamp;
+    backward.dist[target] = 0.0;
+    backward.parent[target] = INVALID_NODE;
+    backward.queue.push(target, -potential(target));
+    queueStats.countPush(2);
+
+    if (source == target) {
+        meetingNode = source;
+        bestDistance = 0.0;
+        return;
+    }
+
+    while (!forward.queue.empty() && !backward.queue.empty()) {
+        double topForward = forward.queue.top().key;
+        double topBackward = backward.queue.top().key;
+        if (topForward + topBackward >= bestDistance) {
+            break;
+        }
+
+        bool isForward = topForward <= topBackward;
+        Side& side = isForward ? forward : backward;
+        Side& other = isForward ? backward : forward;
+
+        NodeId current = side.queue.pop().node;
+        queueStats.countPop();
+        settled++;
+
+        EdgeId begin = isForward ? graph.firstEdge(current) : graph.firstReverseEdge(current);
+        EdgeId end = isForward ? graph.endEdge(current) : graph.endReverseEdge(current);
+        for (EdgeId e = begin; e < end; ++e) {
+            NodeId neighbor = isForward ? graph.target(e) : graph.reverseSource(e);
+            double weight = isForward ? graph.weight(e, metric) : graph.reverseWeight(e, metric);
+            double newDistance = side.dist[current] + weight;
+            relaxed++;
+
+            if (!reached(side, neighbor) || newDistance < side.dist[neighbor]) {
+                side.stamp[neighbor] = currentStamp;
+                side.dist[neighbor] = newDistance;
+                side.parent[neighbor] = current;
+                side.queue.push(neighbor, isForward ? newDistance + potential(neighbor)
+                                                    : newDistance - potential(neighbor));
+                queueStats.countPush(forward.queue.size() + backward.queue.size());
+            }
+
+            if (reached(other, neighbor) && side.dist[neighbor] + other.dist[neighbor] < bestDistance) {
+                bestDistance = side.dist[neighbor] + other.dist[neighbor];
+                meetingNode = neighbor;
+            }
+        }
+    }
+}
+
+void BidirectionalSearch::run(const RoadGraph& graph, NodeId source, NodeId target, Metric metric) {
+    runWithPotential(graph, source, target, metric, ZeroPotential());
+}
+
+void BidirectionalSearch::runAStar(const RoadGraph& graph, NodeId source, NodeId target, Metric metric,
+                                   const GeoHeuristic& heuristic) {
+    runWithPotential(graph, source, target, metric, AveragePotential{heuristic, source, target, metric});
+}
+
+std::vector<NodeId> BidirectionalSearch::path() const {
+    std::vector<NodeId> nodes;
+    if (meetingNode == INVALID_NODE) {
+        return nodes;
+    }
+
+    for (NodeId current = meetingNode; current != INVALID_NODE; current = forward.parent[current]) {
+        nodes.push_back(current);
+    }
+    std::reverse(nodes.begin(), nodes.end());
+    for (NodeId current = backward.parent[meetingNode]; current != INVALID_NODE; current = backward.parent[current]) {
+        nodes.push_back(current);
+    }
+    return nodes;
+}
+
+SearchStats BidirectionalSearch::searchStats() const {
+    SearchStats stats = queueStats;
+    stats.settled = settled;
+    stats.relaxed = relaxed;
+    return stats;
+}
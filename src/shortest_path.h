@@ -0,0 +1,162 @@
+#ifndef SHORTEST_PATH_H
+#define SHORTEST_PATH_H
+
+#include "road_graph.h"
+#include "priority_queues.h"
+#include "search_stats.h"
+#include <vector>
+#include <string>
+
+/**
+ * Shortest Path Search Engines
+ * Priority-queue searches over RoadGraph with reusable per-node state, so a
+ * query only pays for the nodes it touches rather than for the whole graph
+ */
+
+enum class QueueType {
+    BinaryHeap,     // lazy deletion
+    QuaternaryHeap, // indexed 4-ary heap with decrease-key
+    PairingHeap,
+    RadixHeap       // monotone keys only
+};
+
+std::string queueTypeName(QueueType queue);
+
+class LandmarkTable;
+
+enum class HeuristicMode {
+    Haversine,      // exact great-circle distance
+    Equirectangular // flat projection scaled down to stay a lower bound, no trig per call
+};
+
+/**
+ * Great-circle lower bounds between nodes, with the per-node trig terms
+ * (latitude/longitude in radians, cos of latitude) computed once per graph
+ */
+class GeoHeuristic {
+private:
+    std::vector<double> latRad;
+    std::vector<double> lonRad;
+    std::vector<double> cosLat;
+    double equirectScale; // sinc bound over the graph's coordinate span
+    double maxSpeed;      // fastest edge in km/h, turns distance bounds into time bounds
+
+public:
+    GeoHeuristic();
+
+    void build(const RoadGraph& graph);
+    bool empty() const { return latRad.empty(); }
+    double fastestSpeed() const { return maxSpeed; }
+
+    double haversine(NodeId from, NodeId to) const;
+    double equirectangular(NodeId from, NodeId to) const;
+
+    // Lower bound on the metric cost from -> to
+    double estimate(NodeId from, NodeId to, Metric metric, HeuristicMode mode) const;
+};
+
+class DijkstraSearch {
+private:
+    std::vector<double> dist;
+    std::vector<EdgeId> parentEdge;
+    std::vector<NodeId> parent;
+    std::vector<uint32_t> stamp;   // entries are valid only when stamp == currentStamp
+    uint32_t currentStamp;
+    size_t settled;
+    size_t relaxed;
+    SearchStats queueStats; // queue hooks, see search_stats.h
+
+    LazyBinaryHeap<double> binaryHeap;
+    IndexedDaryHeap<double, 4> quaternaryHeap;
+    PairingHeap<double> pairingHeap;
+    RadixHeap<double> radixHeap;
+
+    void prepare(size_t nodeCount);
+    bool reached(NodeId node) const { return stamp[node] == currentStamp; }
+
+    template <typename Queue, typename Potential>
+    void runWithQueue(Queue& queue, const RoadGraph& graph, NodeId source, NodeId target, Metric metric,
+                      const Potential& potential);
+
+public:
+    DijkstraSearch();
+
+    // Single-source search; stops once `target` is settled unless target is INVALID_NODE
+    void run(const RoadGraph& graph, NodeId source, NodeId target = INVALID_NODE,
+             Metric metric = Metric::Distance, QueueType queue = QueueType::QuaternaryHeap);
+
+    // A* towards target; the queue must tolerate non-monotone keys, so the
+    // radix heap is not accepted and falls back to the 4-ary heap
+    void runAStar(const RoadGraph& graph, NodeId source, NodeId target, Metric metric,
+                  const GeoHeuristic& heuristic, HeuristicMode mode = HeuristicMode::Haversine,
+                  QueueType queue = QueueType::QuaternaryHeap);
+
+    // A* with ALT landmark bounds; the table's metric is used
+    void runALT(const RoadGraph& graph, NodeId source, NodeId target, const LandmarkTable& landmarks);
+
+    double distanceTo(NodeId node) const { return reached(node) ? dist[node] : INFINITE_WEIGHT; }
+    NodeId parentOf(NodeId node) const { return reached(node) ? parent[node] : INVALID_NODE; }
+    EdgeId parentEdgeOf(NodeId node) const { return reached(node) ? parentEdge[node] : INVALID_EDGE; }
+
+    // Node sequence source..node, empty when node was not reached
+    std::vector<NodeId> pathTo(NodeId node) const;
+
+    size_t settledCount() const { return settled; }
+    size_t relaxedCount() const { return relaxed; }
+    // Counters of the last run; queue counters need PATHFINDING_STATS
+    SearchStats searchStats() const;
+};
+
+/**
+ * Bidirectional Dijkstra / A*
+ * Forward search over outgoing arcs from the source, backward search over
+ * incoming arcs from the target, stopping once top_f + top_b >= mu (the best
+ * meeting path so far). A* uses the average potential
+ * p_f(v) = (h(v, target) - h(source, v)) / 2 and p_b = -p_f, which keeps both
+ * directions consistent; only the haversine bound is used, since the scaled
+ * equirectangular bound is admissible but not guaranteed consistent.
+ */
+class BidirectionalSearch {
+private:
+    struct Side {
+        std::vector<double> dist;
+        std::vector<NodeId> parent; // predecessor in this side's search tree
+        std::vector<uint32_t> stamp;
+        IndexedDaryHeap<double, 4> queue;
+    };
+
+    Side forward;
+    Side backward;
+    uint32_t currentStamp;
+    NodeId meetingNode;
+    double bestDistance;
+    size_t settled;
+    size_t relaxed;
+    SearchStats queueStats;
+
+    void prepare(size_t nodeCount);
+    bool reached(const Side& side, NodeId node) const { return side.stamp[node] == currentStamp; }
+
+    template <typename Potential>
+    void runWithPotential(const RoadGraph& graph, NodeId source, NodeId target, Metric metric,
+                          const Potential& potential);
+
+public:
+    BidirectionalSearch();
+
+    void run(const RoadGraph& graph, NodeId source, NodeId target, Metric metric = Metric::Distance);
+    void runAStar(const RoadGraph& graph, NodeId source, NodeId target, Metric metric,
+                  const GeoHeuristic& heuristic);
+
+    double distance() const { return bestDistance; }
+    NodeId meetingPoint() const { return meetingNode; }
+
+    // Node sequence source..target, empty when unreachable
+    std::vector<NodeId> path() const;
+
+    size_t settledCount() const { return settled; }
+    size_t relaxedCount() const { return relaxed; }
+    SearchStats searchStats() const;
+};
+
+#endif // SHORTEST_PATH_H
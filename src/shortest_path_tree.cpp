@@ -0,0 +1,144 @@
+#include "shortest_path_tree.h"
+#include <algorithm>
+
+ShortestPathTree::ShortestPathTree() : root(INVALID_NODE), metric(Metric::Distance), currentMark(0) {}
+
+ShortestPathTree ShortestPathTree::build(const RoadGraph& graph, NodeId source, Metric metric) {
+    ShortestPathTree tree;
+    tree.root = source;
+    tree.metric = metric;
+    tree.dist.assign(graph.nodeCount(), INFINITE_WEIGHT);
+    tree.parent.assign(graph.nodeCount(), INVALID_NODE);
+    tree.mark.assign(graph.nodeCount(), 0);
+    if (source >= graph.nodeCount()) {
+        return tree;
+    }
+
+    tree.queue.clear();
+    tree.queue.reserve(graph.nodeCount());
+    tree.dist[source] = 0.0;
+    tree.queue.push(source, 0.0);
+    tree.propagate(graph);
+    return tree;
+}
+
+// Dijkstra from whatever is queued; every queued node already holds its
+// tentative distance and parent
+size_t ShortestPathTree::propagate(const RoadGraph& graph) {
+    size_t settled = 0;
+    while (!queue.empty()) {
+        NodeId current = queue.pop().node;
+        settled++;
+
+        for (EdgeId e = graph.firstEdge(current); e < graph.endEdge(current); ++e) {
+            NodeId neighbor = graph.target(e);
+            double newDistance = dist[current] + graph.weight(e, metric);
+            if (newDistance < dist[neighbor]) {
+                dist[neighbor] = newDistance;
+                parent[neighbor] = current;
+                queue.push(neighbor, newDistance);
+            }
+        }
+    }
+    return settled;
+}
+
+size_t ShortestPathTree::repair(const RoadGraph& graph, const std::vector<ArcChange>& changes) {
+    if (root >= graph.nodeCount()) {
+        return 0;
+    }
+    size_t nodeCount = graph.nodeCount();
+    if (dist.size() < nodeCount) {
+        dist.resize(nodeCount, INFINITE_WEIGHT);
+        parent.resize(nodeCount, INVALID_NODE);
+        mark.resize(nodeCount, 0);
+    }
+    if (++currentMark == 0) {
+        std::fill(mark.begin(), mark.end(), 0);
+        currentMark = 1;
+    }
+    queue.clear();
+    queue.reserve(nodeCount);
+
+    auto arcWeight = [&](NodeId from, NodeId to) {
+        EdgeId edge = graph.findEdge(from, to);
+        return edge == INVALID_EDGE ? INFINITE_WEIGHT : graph.weight(edge, metric);
+    };
+
+    // Tree arcs that became more expensive (or vanished): everything below
+    // them may have to take another route
+    std::vector<NodeId> affectedNodes;
+    std::vector<NodeId> stack;
+    for (const auto& change : changes) {
+        NodeId from = change.first, to = change.second;
+        if (from >= nodeCount || to >= nodeCount || parent[to] != from || affected(to)) {
+            continue;
+        }
+        if (dist[from] + arcWeight(from, to) <= dist[to]) {
+            continue;
+        }
+        stack.push_back(to);
+        mark[to] = currentMark;
+        while (!stack.empty()) {
+            NodeId node = stack.back();
+            stack.pop_back();
+            affectedNodes.push_back(node);
+            for (EdgeId e = graph.firstEdge(node); e < graph.endEdge(node); ++e) {
+                NodeId child = graph.target(e);
+                if (parent[child] == node && !affected(child)) {
+                    mark[child] = currentMark;
+                    stack.push_back(child);
+                }
+            }
+        }
+    }
+
+    for (NodeId node : affectedNodes) {
+        dist[node] = INFINITE_WEIGHT;
+        parent[node] = INVALID_NODE;
+    }
+    // Cheapest way into each affected node from the intact part of the tree
+    for (NodeId node : affectedNodes) {
+        for (EdgeId r = graph.firstReverseEdge(node); r < graph.endReverseEdge(node); ++r) {
+            NodeId from = graph.reverseSource(r);
+            if (affected(from) || dist[from] == INFINITE_WEIGHT) {
+                continue;
+            }
+            double candidate = dist[from] + graph.reverseWeight(r, metric);
+            if (candidate < dist[node]) {
+                dist[node] = candidate;
+                parent[node] = from;
+            }
+        }
+        if (dist[node] != INFINITE_WEIGHT) {
+            queue.push(node, dist[node]);
+        }
+    }
+
+    // Arcs that became cheaper (or appeared)
+    for (const auto& change : changes) {
+        NodeId from = change.first, to = change.second;
+        if (from >= nodeCount || to >= nodeCount || dist[from] == INFINITE_WEIGHT) {
+            continue;
+        }
+        double candidate = dist[from] + arcWeight(from, to);
+        if (candidate < dist[to]) {
+            dist[to] = candidate;
+            parent[to] = from;
+            queue.push(to, candidate);
+        }
+    }
+
+    return propagate(graph);
+}
+
+std::vector<NodeId> ShortestPathTree::pathTo(NodeId node) const {
+    std::vector<NodeId> path;
+    if (node >= dist.size() || dist[node] == INFINITE_WEIGHT) {
+        return path;
+    }
+    for (NodeId current = node; current != INVALID_NODE; current = parent[current]) {
+        path.push_back(current);
+    }
+    return std::vector<NodeId>(path.rbegin(), path.rend());
+}
@@ -0,0 +1,60 @@
+#ifndef SHORTEST_PATH_TREE_H
+#define SHORTEST_PATH_TREE_H
+
+#include "road_graph.h"
+#include "priority_queues.h"
+#include <vector>
+#include <utility>
+
+/**
+ * Dynamic Shortest-Path Tree
+ * Complete single-source tree that can be repaired after the graph changes
+ * instead of being grown again (Ramalingam-Reps). Arcs that got cheaper, or
+ * were inserted, seed a Dijkstra from their heads. Tree arcs that got more
+ * expensive, or were removed, invalidate the subtree below them; those nodes
+ * are re-seeded from their best unaffected in-neighbour and then settled by
+ * the same Dijkstra. Work is proportional to the part of the tree whose
+ * distances actually change, plus its neighbourhood.
+ */
+
+using ArcChange = std::pair<NodeId, NodeId>; // (from, to) of an arc whose weight changed
+
+class ShortestPathTree {
+private:
+    NodeId root;
+    Metric metric;
+    std::vector<double> dist;
+    std::vector<NodeId> parent;
+
+    // Repair scratch space
+    std::vector<uint32_t> mark; // affected when mark == currentMark
+    uint32_t currentMark;
+    IndexedDaryHeap<double, 4> queue;
+
+    bool affected(NodeId node) const { return mark[node] == currentMark; }
+    size_t propagate(const RoadGraph& graph);
+
+public:
+    ShortestPathTree();
+
+    // Full Dijkstra from source
+    static ShortestPathTree build(const RoadGraph& graph, NodeId source, Metric metric);
+
+    // Brings the tree up to date with `graph` after the listed arcs were
+    // reweighted, inserted or removed. Node ids must be unchanged; nodes
+    // appended since the last build start out unreachable. Undirected graphs
+    // need both directions of a changed road listed. Returns the number of
+    // nodes settled during the repair.
+    size_t repair(const RoadGraph& graph, const std::vector<ArcChange>& changes);
+
+    NodeId source() const { return root; }
+    Metric getMetric() const { return metric; }
+    size_t nodeCount() const { return dist.size(); }
+    double distanceTo(NodeId node) const { return node < dist.size() ? dist[node] : INFINITE_WEIGHT; }
+    NodeId parentOf(NodeId node) const { return node < parent.size() ? parent[node] : INVALID_NODE; }
+
+    // Node sequence source..node, empty when node is unreachable
+    std::vector<NodeId> pathTo(NodeId node) const;
+};
+
+#endif // SHORTEST_PATH_TREE_H
@@ -0,0 +1,200 @@
+#include "spatial_index.h"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+namespace {
+
+const double EARTH_RADIUS_KM = 6371.0;
+
+void toUnitVector(double latitude, double longitude, double* xyz) {
+    double lat = latitude * M_PI / 180.0;
+    double lon = longitude * M_PI / 180.0;
+    xyz[0] = std::cos(lat) * std::cos(lon);
+    xyz[1] = std::cos(lat) * std::sin(lon);
+    xyz[2] = std::sin(lat);
+}
+
+// NaN or infinite coordinates fail every distance comparison in the search
+bool isFinitePosition(double latitude, double longitude) {
+    return std::isfinite(latitude) && std::isfinite(longitude);
+}
+
+double chord2To(const double* a, const double* b) {
+    double dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+    return dx * dx + dy * dy + dz * dz;
+}
+
+double chord2ToKm(double chord2) {
+    return 2.0 * EARTH_RADIUS_KM * std::asin(std::min(1.0, std::sqrt(chord2) / 2.0));
+}
+
+double kmToChord2(double km) {
+    double chord = 2.0 * std::sin(std::min(M_PI, km / EARTH_RADIUS_KM) / 2.0);
+    return chord * chord;
+}
+
+} // namespace
+
+SpatialIndex SpatialIndex::build(const RoadGraph& graph) {
+    SpatialIndex index;
+    if (!graph.hasCoordinates()) {
+        return index;
+    }
+    index.points.resize(graph.nodeCount());
+    for (NodeId node = 0; node < graph.nodeCount(); ++node) {
+        toUnitVector(graph.latitude(node), graph.longitude(node), index.points[node].xyz);
+        index.points[node].node = node;
+    }
+    // Ranges halve evenly, so every leaf sits on one of the two deepest levels
+    size_t leaves = 1;
+    while (leaves * LEAF_SIZE < index.points.size()) leaves *= 2;
+    index.splits.resize(leaves > 1 ? leaves - 1 : 0);
+    index.buildRange(0, 0, index.points.size());
+    return index;
+}
+
+void SpatialIndex::buildRange(size_t tree, size_t begin, size_t end) {
+    if (end - begin <= LEAF_SIZE) {
+        return;
+    }
+
+    // Split on the axis with the widest spread
+    double low[3] = {2.0, 2.0, 2.0}, high[3] = {-2.0, -2.0, -2.0};
+    for (size_t i = begin; i < end; ++i) {
+        for (int axis = 0; axis < 3; ++axis) {
+            low[axis] = std::min(low[axis], points[i].xyz[axis]);
+            high[axis] = std::max(high[axis], points[i].xyz[axis]);
+        }
+    }
+    uint32_t axis = 0;
+    for (uint32_t a = 1; a < 3; ++a) {
+        if (high[a] - low[a] > high[axis] - low[axis]) axis = a;
+    }
+
+    size_t mid = begin + (end - begin) / 2;
+    std::nth_element(points.begin() + begin, points.begin() + mid, points.begin() + end,
+                     [axis](const Point& a, const Point& b) { return a.xyz[axis] < b.xyz[axis]; });
+    splits[tree].value = points[mid].xyz[axis];
+    splits[tree].axis = axis;
+    buildRange(2 * tree + 1, begin, mid);
+    buildRange(2 * tree + 2, mid, end);
+}
+
+template <typename Visit>
+void SpatialIndex::searchRange(size_t tree, size_t begin, size_t end, Probe& probe, double cellChord2,
+                               double& limitChord2, Visit& visit) const {
+    if (end - begin <= LEAF_SIZE) {
+        for (size_t i = begin; i < end; ++i) {
+            double chord2 = chord2To(points[i].xyz, probe.xyz);
+            if (chord2 <= limitChord2) visit(points[i], chord2, limitChord2);
+        }
+        return;
+    }
+
+    // Near side first so the limit shrinks before the far side is considered.
+    // The far cell is at least as far away as the near one, with this axis's
+    // gap replaced by the distance to the splitting plane.
+    size_t mid = begin + (end - begin) / 2;
+    uint32_t axis = splits[tree].axis;
+    double offset = probe.xyz[axis] - splits[tree].value;
+    size_t nearTree = offset < 0 ? 2 * tree + 1 : 2 * tree + 2;
+    size_t farTree = offset < 0 ? 2 * tree + 2 : 2 * tree + 1;
+    if (offset < 0) {
+        searchRange(nearTree, begin, mid, probe, cellChord2, limitChord2, visit);
+    } else {
+        searchRange(nearTree, mid, end, probe, cellChord2, limitChord2, visit);
+    }
+
+    double gap = probe.cellGap[axis];
+    double farChord2 = cellChord2 - gap * gap + offset * offset;
+    if (farChord2 <= limitChord2) {
+        probe.cellGap[axis] = offset;
+        if (offset < 0) {
+            searchRange(farTree, mid, end, probe, farChord2, limitChord2, visit);
+        } else {
+            searchRange(farTree, begin, mid, probe, farChord2, limitChord2, visit);
+        }
+        probe.cellGap[axis] = gap;
+    }
+}
+
+SpatialMatch SpatialIndex::nearest(double latitude, double longitude) const {
+    if (points.empty() || !isFinitePosition(latitude, longitude)) {
+        return SpatialMatch();
+    }
+    Probe probe;
+    toUnitVector(latitude, longitude, probe.xyz);
+
+    const Point* best = nullptr;
+    double limit = INFINITE_WEIGHT;
+    auto visit = [&](const Point& point, double chord2, double& limitChord2) {
+        if (!best || chord2 < limitChord2) {
+            best = &point;
+            limitChord2 = chord2;
+        }
+    };
+    searchRange(0, 0, points.size(), probe, 0.0, limit, visit);
+    if (!best) {
+        return SpatialMatch(); // only non-finite node coordinates
+    }
+    return SpatialMatch(best->node, chord2ToKm(limit));
+}
+
+std::vector<SpatialMatch> SpatialIndex::nearestK(double latitude, double longitude, size_t k) const {
+    std::vector<SpatialMatch> matches;
+    if (points.empty() || k == 0 || !isFinitePosition(latitude, longitude)) {
+        return matches;
+    }
+    Probe probe;
+    toUnitVector(latitude, longitude, probe.xyz);
+
+    // Max-heap of the k best so far; its top bounds the search once full
+    std::priority_queue<std::pair<double, NodeId>> closest;
+    double limit = INFINITE_WEIGHT;
+    auto visit = [&](const Point& point, double chord2, double& limitChord2) {
+        if (closest.size() < k) {
+            closest.emplace(chord2, point.node);
+        } else if (chord2 < closest.top().first) {
+            closest.pop();
+            closest.emplace(chord2, point.node);
+        }
+        if (closest.size() == k) limitChord2 = closest.top().first;
+    };
+    searchRange(0, 0, points.size(), probe, 0.0, limit, visit);
+
+    matches.resize(closest.size());
+    for (size_t i = matches.size(); i-- > 0;) {
+        matches[i] = SpatialMatch(closest.top().second, chord2ToKm(closest.top().first));
+        closest.pop();
+    }
+    return matches;
+}
+
+std::vector<SpatialMatch> SpatialIndex::withinRadius(double latitude, double longitude, double radiusKm) const {
+    std::vector<std::pair<double, NodeId>> found;
+    if (!points.empty() && radiusKm >= 0.0 && isFinitePosition(latitude, longitude)) {
+        Probe probe;
+        toUnitVector(latitude, longitude, probe.xyz);
+        double limit = kmToChord2(radiusKm);
+        auto visit = [&](const Point& point, double chord2, double&) { found.emplace_back(chord2, point.node); };
+        searchRange(0, 0, points.size(), probe, 0.0, limit, visit);
+    }
+
+    std::sort(found.begin(), found.end());
+    std::vector<SpatialMatch> matches;
+    matches.reserve(found.size());
+    for (const auto& match : found) {
+        matches.emplace_back(match.second, chord2ToKm(match.first));
+    }
+    return matches;
+}
+
+std::vector<SpatialMatch> SpatialIndex::snap(const std::vector<std::pair<double, double>>& positions,
+                                             unsigned threads) const {
+    std::vector<SpatialMatch> matches(positions.size());
+    parallelFor(positions.size(), threads, [&](size_t i, unsigned) {
+        matches[i] = nearest(positions[i].first, positions[i].second);
+    }, 1024);
+    return matches;
+}
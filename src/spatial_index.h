@@ -0,0 +1,81 @@
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include "road_graph.h"
+#include "parallel.h"
+#include <vector>
+#include <utility>
+
+/**
+ * Spatial Node Index
+ * Static k-d tree over node coordinates, used to snap raw GPS positions to
+ * graph nodes. Points are stored as unit vectors on the sphere, so straight
+ * (chord) distance orders points exactly like great-circle distance, with
+ * no special cases at the poles or the antimeridian. The tree is implicit:
+ * every range is halved at its median along the widest axis until at most
+ * LEAF_SIZE points remain, which are scanned linearly. Points sit in one
+ * array in tree order, and the splitting planes in a separate heap-ordered
+ * array, so the top levels of a descent stay in cache on large graphs.
+ */
+
+struct SpatialMatch {
+    NodeId node;
+    double distanceKm; // great-circle distance from the query point
+
+    SpatialMatch() : node(INVALID_NODE), distanceKm(INFINITE_WEIGHT) {}
+    SpatialMatch(NodeId n, double km) : node(n), distanceKm(km) {}
+};
+
+class SpatialIndex {
+private:
+    static const size_t LEAF_SIZE = 8;
+
+    struct Point {
+        double xyz[3];
+        NodeId node;
+    };
+
+    struct Split {
+        double value;
+        uint32_t axis;
+    };
+
+    std::vector<Point> points; // tree order
+    std::vector<Split> splits; // per internal node; children of i are 2i+1, 2i+2
+
+    // Query point plus its per-axis gap to the current cell
+    struct Probe {
+        double xyz[3];
+        double cellGap[3] = {0.0, 0.0, 0.0};
+    };
+
+    void buildRange(size_t tree, size_t begin, size_t end);
+    // Calls visit(point, chord2, limitChord2) for every point within
+    // limitChord2 of the probe; visit may tighten the limit as it goes
+    template <typename Visit>
+    void searchRange(size_t tree, size_t begin, size_t end, Probe& probe, double cellChord2,
+                     double& limitChord2, Visit& visit) const;
+
+public:
+    static SpatialIndex build(const RoadGraph& graph);
+
+    bool empty() const { return points.empty(); }
+    size_t size() const { return points.size(); }
+
+    // Closest node; node is INVALID_NODE for an empty index or a non-finite
+    // position (the other queries return no matches for one)
+    SpatialMatch nearest(double latitude, double longitude) const;
+
+    // Up to k closest nodes, nearest first
+    std::vector<SpatialMatch> nearestK(double latitude, double longitude, size_t k) const;
+
+    // Every node within radiusKm, nearest first
+    std::vector<SpatialMatch> withinRadius(double latitude, double longitude, double radiusKm) const;
+
+    // nearest() for each (latitude, longitude), spread over `threads` workers;
+    // non-finite positions yield INVALID_NODE
+    std::vector<SpatialMatch> snap(const std::vector<std::pair<double, double>>& positions,
+                                   unsigned threads = defaultThreadCount()) const;
+};
+
+#endif // SPATIAL_INDEX_H
@@ -0,0 +1,153 @@
+/**
+ * Static Serving Benchmark
+ * Compares requests per second for the frontend assets between the old
+ * handler (fs.readFile on every request, no compression, no cache headers)
+ * and server.js with its in-memory asset cache. Each server runs in its
+ * own process; this process drives it with keep-alive connections.
+ * Usage: node static_bench.js [seconds] [connections]
+ */
+
+const http = require('http');
+const fs = require('fs');
+const path = require('path');
+const { spawn } = require('child_process');
+
+const DIRECTORY = path.join(__dirname, 'frontend');
+const BASELINE_PORT = 3101;
+const CACHED_PORT = 3102;
+
+// The handler server.js used before the asset cache, minus the 404 page
+function runBaselineServer(port) {
+    const mimeTypes = { '.html': 'text/html', '.js': 'text/javascript', '.css': 'text/css' };
+    http.createServer((req, res) => {
+        let pathname = new URL(req.url, 'http://localhost').pathname;
+        if (pathname === '/') pathname = '/combined.html';
+        const filePath = path.join(DIRECTORY, pathname);
+        fs.readFile(filePath, (err, data) => {
+            if (err) {
+                res.writeHead(404);
+                res.end();
+                return;
+            }
+            res.setHeader('Access-Control-Allow-Origin', '*');
+            res.writeHead(200, { 'Content-Type': mimeTypes[path.extname(filePath)] || 'application/octet-stream' });
+            res.end(data);
+        });
+    }).listen(port);
+}
+
+function startServer(args, env, port) {
+    return new Promise((resolve, reject) => {
+        const child = spawn(process.execPath, args, {
+            cwd: __dirname,
+            env: { ...process.env, ...env, PORT: String(port), OPEN_BROWSER: '0' },
+            stdio: ['ignore', 'ignore', 'inherit']
+        });
+        child.on('error', reject);
+        // Poll until the port answers
+        const probe = () => {
+            http.get({ port, path: '/' }, (res) => {
+                res.resume();
+                resolve(child);
+            }).on('error', () => setTimeout(probe, 50));
+        };
+        probe();
+    });
+}
+
+function request(agent, port, pathname, headers) {
+    return new Promise((resolve, reject) => {
+        const start = process.hrtime.bigint();
+        const req = http.get({ agent, port, path: pathname, headers }, (res) => {
+            let bytes = 0;
+            res.on('data', (chunk) => { bytes += chunk.length; });
+            res.on('end', () => resolve({
+                status: res.statusCode,
+                etag: res.headers.etag,
+                bytes,
+                micros: Number(process.hrtime.bigint() - start) / 1000
+            }));
+        });
+        req.on('error', reject);
+    });
+}
+
+// Every connection walks the asset list until time runs out
+async function measure(port, assets, seconds, connections, revalidate) {
+    const agent = new http.Agent({ keepAlive: true, maxSockets: connections });
+    const etags = new Map();
+    if (revalidate) {
+        for (const asset of assets) {
+            etags.set(asset, (await request(agent, port, asset, { 'Accept-Encoding': 'br, gzip' })).etag);
+        }
+    }
+
+    const latencies = [];
+    let bytes = 0;
+    let errors = 0;
+    const deadline = Date.now() + seconds * 1000;
+    const worker = async (offset) => {
+        for (let i = offset; Date.now() < deadline; i++) {
+            const asset = assets[i % assets.length];
+            const headers = { 'Accept-Encoding': 'br, gzip' };
+            if (revalidate) headers['If-None-Match'] = etags.get(asset);
+            const result = await request(agent, port, asset, headers);
+            if (result.status !== (revalidate ? 304 : 200)) errors++;
+            latencies.push(result.micros);
+            bytes += result.bytes;
+        }
+    };
+
+    const start = Date.now();
+    await Promise.all(Array.from({ length: connections }, (_, c) => worker(c)));
+    const elapsed = (Date.now() - start) / 1000;
+    agent.destroy();
+
+    latencies.sort((a, b) => a - b);
+    const at = (fraction) => latencies[Math.min(latencies.length - 1, Math.floor(fraction * latencies.length))];
+    return {
+        rps: latencies.length / elapsed,
+        kbPerRequest: bytes / latencies.length / 1024,
+        p50: at(0.5),
+        p99: at(0.99),
+        errors
+    };
+}
+
+async function main() {
+    const seconds = parseFloat(process.argv[2]) || 5;
+    const connections = parseInt(process.argv[3], 10) || 16;
+    const assets = fs.readdirSync(DIRECTORY).map((name) => `/${name}`);
+
+    const baseline = await startServer([__filename, '--baseline-server'], {}, BASELINE_PORT);
+    const cached = await startServer([path.join(__dirname, 'server.js')], {}, CACHED_PORT);
+
+    console.log(`Static benchmark: ${assets.length} assets, ${connections} keep-alive connections, ${seconds}s each`);
+    const scenarios = [
+        ['readFile per request (before)', BASELINE_PORT, false],
+        ['asset cache, compressed (after)', CACHED_PORT, false],
+        ['asset cache, If-None-Match 304 (after)', CACHED_PORT, true]
+    ];
+    let baselineRps = 0;
+    for (const [name, port, revalidate] of scenarios) {
+        const result = await measure(port, assets, seconds, connections, revalidate);
+        baselineRps = baselineRps || result.rps;
+        console.log(`  ${name.padEnd(40)} ${result.rps.toFixed(0).padStart(7)} req/s` +
+            `  ${(result.rps / baselineRps).toFixed(2)}x` +
+            `  ${result.kbPerRequest.toFixed(1).padStart(5)} KB/req` +
+            `  p50 ${(result.p50 / 1000).toFixed(2)} ms  p99 ${(result.p99 / 1000).toFixed(2)} ms` +
+            (result.errors ? `  (${result.errors} unexpected statuses)` : ''));
+    }
+
+    baseline.kill('SIGINT');
+    cached.kill('SIGINT');
+}
+
+if (process.argv[2] === '--baseline-server') {
+    runBaselineServer(parseInt(process.env.PORT, 10));
+} else {
+    main().catch((error) => {
+        console.error('❌ Benchmark failed:', error);
+        process.exit(1);
+    });
+}